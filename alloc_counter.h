@@ -0,0 +1,5 @@
+#pragma once
+
+// counts heap allocations made through global operator new. Linking
+// alloc_counter.cpp into a binary replaces operator new/delete for it.
+long long allocationCount();
@@ -0,0 +1,172 @@
+// batch runner: plays many independent seeded games across every core and
+// prints aggregate results, for balance tuning
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bot.h"
+#include "sim.h"
+#include "waves.h"
+#include "workers.h"
+
+// what one game ended with (the HUD counters plus how it finished)
+struct gameResult {
+    int score = 0;
+    int round = 0;
+    int hits = 0;
+    int shots = 0;
+    long long ticks = 0;
+    endReason ended = END_NONE; // END_NONE = hit the tick limit
+};
+
+static const char* endName(endReason e) {
+    switch (e) {
+    case END_INVADED: return "invaded";
+    case END_SHOT: return "shot";
+    case END_CLEARED: return "cleared";
+    default: return "timeout";
+    }
+}
+
+// the power-up kind named by an option like --shield-odds, or -1
+static int kindOption(const char* arg, const char* suffix) {
+    for (int k = 0; k < POWERUP_KINDS; k++) {
+        std::string name = std::string("--") + powerupKinds[k].name + suffix;
+        if (name == arg) return k;
+    }
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    int games = 1000;
+    int threads = hardwareThreads();
+    unsigned long long seed = 1;
+    bool scripted = false;
+    long long maxTicks = 20 * 60 * TICK_RATE; // 20 minutes of play
+    const char* csvPath = nullptr;
+    int stepTicks = 1;
+    game config; // wave size and balance knobs every game starts from
+    static waveFile waves;
+
+    int k; // power-up kind of a per-kind option
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) games = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--scripted")) scripted = true;
+        else if (!strcmp(argv[i], "--max-ticks") && i + 1 < argc) maxTicks = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--csv") && i + 1 < argc) csvPath = argv[++i];
+        else if (!strcmp(argv[i], "--step-ticks") && i + 1 < argc) stepTicks = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--rows") && i + 1 < argc) config.waveRows = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cols") && i + 1 < argc) config.waveCols = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--waves") && i + 1 < argc) {
+            if (!waves.open(argv[++i])) {
+                printf("could not load waves %s: %s\n", argv[i], waves.error);
+                return 1;
+            }
+            waves.use(config);
+        }
+        else if (!strcmp(argv[i], "--speedup") && i + 1 < argc) config.roundSpeedUp = (float)atof(argv[++i]);
+        else if ((k = kindOption(argv[i], "-odds")) >= 0 && i + 1 < argc) config.dropOdds[k] = atoi(argv[++i]);
+        else if ((k = kindOption(argv[i], "-ticks")) >= 0 && i + 1 < argc) config.effectTicks[k] = atoi(argv[++i]);
+        else {
+            printf("usage: %s [--games N] [--threads T] [--seed S] [--scripted] [--max-ticks N] [--csv FILE]\n"
+                "       [--rows R] [--cols C] [--speedup F] [--waves FILE] [--step-ticks K]\n"
+                "       [--slow-odds N] [--homing-odds N] [--shield-odds N]\n"
+                "       [--slow-ticks N] [--homing-ticks N] [--shield-ticks N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (stepTicks > 1 && !scripted) {
+        // the bot reacts to the game every tick, holding its keys would change how it plays
+        printf("--step-ticks needs --scripted\n");
+        return 1;
+    }
+    if (games < 1) games = 1;
+    if (threads < 1) threads = 1;
+
+    // game i is seeded with seed + i, so any single game can be rerun on its own;
+    // each game only writes its own result slot
+    std::vector<gameResult> results(games);
+    auto start = std::chrono::steady_clock::now();
+    parallelFor(games, threads, [&](int i, int) {
+        game g = config;
+        seedGame(g, seed + i);
+        resetGame(g);
+
+        // with --step-ticks a step runs on for as long as the script keeps
+        // holding the same keys
+        long long t = 0;
+        while (t < maxTicks && !g.gameOver) {
+            input in = scripted ? scriptedInput(g, t) : botInput(g, t);
+            int run = 1;
+            while (run < stepTicks && t + run < maxTicks && heldInput(in, scriptedInput(g, t + run))) run++;
+            t += step(g, in, run);
+        }
+
+        gameResult& r = results[i];
+        r.score = g.score;
+        r.round = g.round;
+        r.hits = g.hits;
+        r.shots = g.totalShots;
+        r.ticks = t;
+        r.ended = g.ended;
+    });
+    auto end = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(end - start).count();
+
+    // aggregate
+    long long ticks = 0, hits = 0, shots = 0, rounds = 0;
+    int endCount[END_CLEARED + 1] = {};
+    int lastRound = finalRound(config);
+    std::vector<int> roundCount(lastRound + 1);
+    std::vector<int> scores(games);
+    for (int i = 0; i < games; i++) {
+        const gameResult& r = results[i];
+        ticks += r.ticks;
+        hits += r.hits;
+        shots += r.shots;
+        rounds += r.round;
+        endCount[r.ended]++;
+        roundCount[std::min(r.round, lastRound)]++;
+        scores[i] = r.score;
+    }
+    std::sort(scores.begin(), scores.end());
+    double mean = 0;
+    for (int s : scores) mean += s;
+    mean /= games;
+
+    printf("games: %d on %d threads (%s)\n", games, std::min(threads, games), scripted ? "scripted" : "bot");
+    printf("score: mean %.0f, median %d, p90 %d, max %d\n",
+        mean, scores[games / 2], scores[std::min(games - 1, games * 9 / 10)], scores[games - 1]);
+    printf("round: mean %.2f\n", (double)rounds / games);
+    printf("accuracy: %.1f%% (%lld hits / %lld shots)\n", shots > 0 ? 100.0 * hits / shots : 0.0, hits, shots);
+    printf("length: mean %.1f s of play\n", (double)ticks / games / TICK_RATE);
+    printf("ended:");
+    for (int e = END_INVADED; e <= END_CLEARED; e++)
+        printf(" %s %d (%.1f%%)", endName((endReason)e), endCount[e], 100.0 * endCount[e] / games);
+    printf(" %s %d\n", endName(END_NONE), endCount[END_NONE]);
+    printf("rounds reached:");
+    for (int r = 1; r <= lastRound; r++)
+        if (roundCount[r]) printf(" %d:%d", r, roundCount[r]);
+    printf("\n");
+    printf("time: %.3f s (%.0f games/s, %.0f ticks/s)\n", secs, secs > 0 ? games / secs : 0.0, secs > 0 ? ticks / secs : 0.0);
+
+    if (csvPath) {
+        FILE* f = fopen(csvPath, "w");
+        if (!f) {
+            printf("could not write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(f, "seed,score,round,hits,shots,ticks,ended\n");
+        for (int i = 0; i < games; i++) {
+            const gameResult& r = results[i];
+            fprintf(f, "%llu,%d,%d,%d,%d,%lld,%s\n", seed + i, r.score, r.round, r.hits, r.shots, r.ticks, endName(r.ended));
+        }
+        fclose(f);
+    }
+    return 0;
+}
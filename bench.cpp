@@ -0,0 +1,204 @@
+// microbenchmarks for the hot paths: collisions, a full tick, homing target
+// search, alien fire, particles and each draw function on the software
+// renderer, from the stock wave up to a 64x64 formation with thousands of
+// bullets and 100k particles
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "profiler.h"
+#include "scene.h"
+#include "sim.h"
+#include "simd.h"
+#include "snapshot.h"
+#include "swrender.h"
+#include "targeting.h"
+
+// a frozen moment of play every benchmark starts from
+struct scenario {
+    const char* name;
+    int rows, cols;
+    float pitchX, pitchY, alienY; // packed tighter as the formation grows, so it stays on screen
+    int alienBullets, playerBullets, homingBullets, powerups;
+    int particles;
+};
+
+static const scenario SCENARIOS[] = {
+    { "stock", 4, 8, 60, 40, 400, 8, 4, 0, 1, 1000 },
+    { "large", 16, 32, 28, 20, 560, 1000, 64, 64, 16, 10000 },
+    { "huge", 64, 64, 14, 7, 580, 4000, 128, 128, 64, 100000 },
+};
+
+static void setup(game& g, const scenario& s) {
+    g = game();
+    seedGame(g, 1);
+    g.waveRows = s.rows;
+    g.waveCols = s.cols;
+    resetGame(g);
+    g.aliens.pitchX = s.pitchX;
+    g.aliens.pitchY = s.pitchY;
+    g.alienY = s.alienY;
+
+    // bullets anywhere above the player, so nothing ends the game on the first tick
+    rng r;
+    r.seed(2, STREAM_COSMETIC);
+    for (int i = 0; i < s.alienBullets; i++)
+        g.alienBullets.push((float)r.below(WIDTH), 80.0f + r.below(HEIGHT - 80), 4.0f);
+    for (int i = 0; i < s.playerBullets; i++)
+        g.playerBullets.push((float)r.below(WIDTH), 50.0f + r.below(HEIGHT - 50), 8.0f);
+    for (int i = 0; i < s.homingBullets; i++)
+        g.homingBullets.push((float)r.below(WIDTH), 50.0f + r.below(HEIGHT - 50), 8.0f);
+    for (int i = 0; i < s.powerups; i++)
+        spawnPowerup(g, (int)r.below(POWERUP_KINDS), (float)r.below(WIDTH), 80.0f + r.below(HEIGHT - 80));
+    if (s.homingBullets) g.effectTimer[POWERUP_HOMING] = g.effectTicks[POWERUP_HOMING];
+}
+
+struct result {
+    std::string name, scenario;
+    long long runs;
+    double medianNs, p90Ns, minNs;
+};
+
+static double minTime = 0.25; // seconds per benchmark
+static const char* filter = nullptr;
+static std::vector<result> results;
+
+// time op() one call at a time, with prepare() run untimed before each call
+// so benchmarks that change the state always start from the same one
+template <typename P, typename F>
+static void bench(const char* name, const scenario& s, P prepare, F op) {
+    std::string full = std::string(name) + "/" + s.name;
+    if (filter && !strstr(full.c_str(), filter)) return;
+
+    typedef std::chrono::steady_clock clock_type;
+    for (int i = 0; i < 3; i++) { prepare(); op(); } // warm caches and lazily built tables
+
+    std::vector<double> ns;
+    auto begin = clock_type::now();
+    while (ns.size() < 20 || (std::chrono::duration<double>(clock_type::now() - begin).count() < minTime && ns.size() < 1000000)) {
+        prepare();
+        auto t0 = clock_type::now();
+        op();
+        auto t1 = clock_type::now();
+        ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+
+    std::sort(ns.begin(), ns.end());
+    result r = { name, s.name, (long long)ns.size(), ns[ns.size() / 2], ns[ns.size() * 9 / 10], ns[0] };
+    printf("%-18s %-6s %12.0f %12.0f %12.0f %9lld\n", name, s.name, r.medianNs, r.p90Ns, r.minNs, r.runs);
+    results.push_back(r);
+}
+
+static bool writeJson(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"compiler\": \"%s\",\n  \"sse2\": %s,\n  \"profile\": %s,\n  \"benchmarks\": [\n",
+#if defined(__VERSION__)
+        __VERSION__,
+#elif defined(_MSC_VER)
+        "msvc",
+#else
+        "unknown",
+#endif
+#ifdef SI_SSE2
+        "true",
+#else
+        "false",
+#endif
+        SI_PROFILE ? "true" : "false");
+    for (size_t i = 0; i < results.size(); i++) {
+        const result& r = results[i];
+        fprintf(f, "    { \"name\": \"%s\", \"scenario\": \"%s\", \"runs\": %lld, \"median_ns\": %.1f, \"p90_ns\": %.1f, \"min_ns\": %.1f }%s\n",
+            r.name.c_str(), r.scenario.c_str(), r.runs, r.medianNs, r.p90Ns, r.minNs, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) minTime = atof(argv[++i]);
+        else {
+            printf("usage: %s [--json FILE] [--filter TEXT] [--min-time SECONDS]\n", argv[0]);
+            return 1;
+        }
+    }
+#if SI_PROFILE
+    printf("note: profiling is compiled in, build with NDEBUG for representative numbers\n");
+#endif
+
+    buildMeshes();
+    static game base, g; // too big for the stack with thousands of bullets
+    softRenderer sw(WIDTH, HEIGHT);
+    batch out;
+    out.verts.reserve(1 << 20);
+    rng cosmetic;
+    cosmetic.seed(3, STREAM_COSMETIC);
+    targetIndex targets;
+    float qx[MAX_HOMING_BULLETS], qy[MAX_HOMING_BULLETS], tx[MAX_HOMING_BULLETS], ty[MAX_HOMING_BULLETS];
+    unsigned char found[MAX_HOMING_BULLETS];
+    static particleSystem effects;
+
+    printf("%-18s %-6s %12s %12s %12s %9s\n", "benchmark", "case", "median ns", "p90 ns", "min ns", "runs");
+    for (const scenario& s : SCENARIOS) {
+        setup(base, s);
+        auto restore = [&] { restoreState(g, base); };
+
+        bench("collisions", s, restore, [&] { checkCollisions(g); });
+
+        input fire;
+        fire.fire = true;
+        bench("tick", s, restore, [&] { step(g, fire); });
+
+        // raw lookup for a full stream of homing bullets spread over the screen
+        for (int i = 0; i < MAX_HOMING_BULLETS; i++) {
+            qx[i] = (float)(i * 37 % WIDTH);
+            qy[i] = (float)(50 + i * 53 % (HEIGHT - 50));
+        }
+        bench("target search", s, [&] { targets.update(base.aliens); }, [&] {
+            targets.nearest(base.alienX, base.alienY, qx, qy, MAX_HOMING_BULLETS, tx, ty, found);
+        });
+        bench("homing steer", s, restore, [&] { steerHoming(g); });
+
+        // every tick fires, a volley per alien column
+        base.alienFireOdds = 1;
+        base.alienVolley = s.cols;
+        bench("alien fire", s, restore, [&] { alienFire(g); });
+        base.alienFireOdds = 25;
+        base.alienVolley = 1;
+
+        // draw into the batch and rasterize it, as one frame's share of that part
+        auto clearBatch = [&] { out.clear(); };
+        auto submit = [&] { sw.triangles(out.verts.data(), (int)out.verts.size()); };
+        bench("draw player", s, clearBatch, [&] { drawPlayer(out, base, base, 0.5f, cosmetic); submit(); });
+        bench("draw aliens", s, clearBatch, [&] { drawAliens(out, base, base, 0.5f); submit(); });
+        bench("draw bullets", s, clearBatch, [&] { drawBullets(out, base, 0.5f); submit(); });
+        bench("draw power-ups", s, clearBatch, [&] { drawPowerups(out, base, 0.5f); submit(); });
+
+        // particles that outlive the run, so the count stays put
+        effects.clear();
+        effects.burst(cosmetic, s.particles, WIDTH / 2, HEIGHT / 2, 10, 200, 1e6f, 1e6f, 1.0f, 0.6f, 0.2f, 1.5f);
+        bench("particle update", s, [] {}, [&] { effects.update(1.0f / TICK_RATE); });
+        bench("particle batch", s, clearBatch, [&] { effects.draw(out); });
+        bench("draw particles", s, clearBatch, [&] { effects.draw(out); submit(); });
+
+        hud h;
+        bench("draw hud", s, [] {}, [&] { h.draw(sw, base); });
+        bench("draw frame", s, [] {}, [&] { renderFrame(sw, out, h, base, base, 0.5f, cosmetic); });
+    }
+
+    if (jsonPath) {
+        if (!writeJson(jsonPath)) {
+            printf("could not write %s\n", jsonPath);
+            return 1;
+        }
+        printf("results written to %s\n", jsonPath);
+    }
+    return 0;
+}
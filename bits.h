@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// portable 64-bit bit tricks (MSVC Win32 has no 64-bit intrinsics, so split there)
+
+inline int popcount64(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return (int)__popcnt64(v);
+#elif defined(_MSC_VER)
+    return (int)(__popcnt((unsigned int)v) + __popcnt((unsigned int)(v >> 32)));
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+// index of the lowest set bit, v must not be 0
+inline int lowestBit(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return (int)i;
+#elif defined(_MSC_VER)
+    unsigned long i;
+    if ((unsigned int)v) {
+        _BitScanForward(&i, (unsigned int)v);
+        return (int)i;
+    }
+    _BitScanForward(&i, (unsigned int)(v >> 32));
+    return (int)i + 32;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// index of the highest set bit, v must not be 0
+inline int highestBit(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return (int)i;
+#elif defined(_MSC_VER)
+    unsigned long i;
+    if (v >> 32) {
+        _BitScanReverse(&i, (unsigned int)(v >> 32));
+        return (int)i + 32;
+    }
+    _BitScanReverse(&i, (unsigned int)v);
+    return (int)i;
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+// index of the k-th (0-based) set bit, k must be < popcount64(v)
+inline int selectBit(uint64_t v, int k) {
+    // skip whole bytes first, then finish inside the byte
+    for (int shift = 0; shift < 64; shift += 8) {
+        int n = popcount64((v >> shift) & 0xff);
+        if (k < n) {
+            uint64_t b = (v >> shift) & 0xff;
+            while (k--) b &= b - 1;
+            return shift + lowestBit(b);
+        }
+        k -= n;
+    }
+    return -1;
+}
@@ -0,0 +1,53 @@
+#include "bot.h"
+#include <cmath>
+
+input scriptedInput(bool gameOver, long long tick) {
+    input in;
+    in.left = (tick / 180) % 2 == 1;
+    in.right = !in.left;
+    in.fire = tick % 12 == 0;
+    in.restart = gameOver;
+    return in;
+}
+
+input botInput(const game& g, long long tick) {
+    input in;
+    in.restart = g.gameOver;
+    if (g.gameOver || g.aliens.empty()) return in;
+
+    // dodge: the closest incoming bullet in a column just wider than the ship
+    const auto& ab = g.alienBullets;
+    float threatX = 0, threatY = 1e9f;
+    for (int i = 0; i < ab.size(); i++) {
+        if (ab.y[i] < 140 && ab.y[i] < threatY && fabs(ab.x[i] - g.playerX) < 32) {
+            threatX = ab.x[i];
+            threatY = ab.y[i];
+        }
+    }
+    if (threatY < 1e9f && !g.effectActive(POWERUP_SHIELD)) {
+        bool goLeft = threatX > g.playerX;
+        if (g.playerX < 60) goLeft = false;
+        if (g.playerX > WIDTH - 60) goLeft = true;
+        in.left = goLeft;
+        in.right = !goLeft;
+        return in;
+    }
+
+    // aim: closest alive column of the formation, led by how far the formation
+    // moves while a shot climbs to its bottom row
+    const formation& f = g.aliens;
+    float climb = (g.alienY - f.bottomRow() * f.pitchY - 50) / 8.0f;
+    float lead = (g.aliensRight ? g.alienSpeed : -g.alienSpeed) * climb;
+    float best = 1e9f, target = g.playerX;
+    for (uint64_t cols = f.colMask; cols; cols &= cols - 1) {
+        float x = g.alienX + lowestBit(cols) * f.pitchX + lead;
+        if (fabs(x - g.playerX) < best) {
+            best = fabs(x - g.playerX);
+            target = x;
+        }
+    }
+    if (target < g.playerX - 4) in.left = true;
+    else if (target > g.playerX + 4) in.right = true;
+    in.fire = best < 12 && tick % 8 == 0;
+    return in;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "sim.h"
+
+// computer players for the headless tools; both restart as soon as a game ends
+
+// sweep left/right and fire every few ticks
+input scriptedInput(bool gameOver, long long tick);
+inline input scriptedInput(const game& g, long long tick) { return scriptedInput(g.gameOver, tick); }
+
+// line up under the closest alien and shoot, sidestepping alien bullets about
+// to land on the player
+input botInput(const game& g, long long tick);
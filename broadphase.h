@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include "sim.h"
+
+// broadphase helpers for checkCollisions(): narrow a query down to a handful
+// of candidates before the exact AABB tests run
+
+// index range [first, last] of lattice cells whose box (cell * pitch +- reach)
+// can overlap the interval [lo, hi], clamped to [0, count - 1]
+// (empty when first > last); the upper end keeps one cell of slack for rounding,
+// the exact AABB test afterwards decides
+inline void latticeRange(float lo, float hi, float pitch, float reach, int count, int& first, int& last) {
+    first = std::max(0, (int)std::floor((lo - reach) / pitch));
+    last = std::min(count - 1, (int)std::floor((hi + reach) / pitch) + 1);
+}
+
+// swept test: a point that moved by (mx, my) relative to the open box
+// (left, right) x (bottom, top) and ended at (x, y). True if its path crossed
+// the box, with t the fraction of the move at which it got in. Callers keep
+// their own test of the end position, so a step with no motion (or a path
+// that only grazes the box) decides exactly as a point test would.
+inline bool sweptEntry(float x, float y, float mx, float my,
+    float left, float bottom, float right, float top, float& t) {
+    float enter = 0, exit = 1;
+    float s[2] = { x - mx, y - my }, m[2] = { mx, my };
+    float lo[2] = { left, bottom }, hi[2] = { right, top };
+    for (int a = 0; a < 2; a++) {
+        if (m[a] == 0) {
+            if (!(s[a] > lo[a] && s[a] < hi[a])) return false;
+            continue;
+        }
+        float t1 = (lo[a] - s[a]) / m[a], t2 = (hi[a] - s[a]) / m[a];
+        if (t1 > t2) std::swap(t1, t2);
+        enter = std::max(enter, t1);
+        exit = std::min(exit, t2);
+        if (!(enter < exit)) return false;
+    }
+    t = enter;
+    return true;
+}
+
+// bullets (x[i], y[i]) vs the alien lattice anchored at (alienX, alienY): each
+// bullet moved by (mx[i], my[i]) relative to the formation since the last
+// test and kills the first alive alien on that path, so fast bullets and long
+// steps don't pass through aliens. Bullets are resolved in order. keep[i] is
+// cleared for bullets that hit and onKill(ax, ay) runs for every kill.
+// Returns the kills.
+template <typename F>
+int hitFormation(formation& f, float alienX, float alienY, int n, const float* x, const float* y,
+    const float* mx, const float* my, unsigned char* keep, F onKill) {
+    int kills = 0;
+    for (int i = 0; i < n; i++) {
+        float bx = x[i], by = y[i];
+        float sx = bx - mx[i], sy = by - my[i]; // where it started
+        int hitR = -1, hitC = -1;
+        float hitT = 2;
+
+        int y1, y2, x1, x2;
+        latticeRange(alienY - std::max(by, sy), alienY - std::min(by, sy), f.pitchY, ALIEN_HALF_SIZE + SHOT_HALF_HEIGHT, f.rows, y1, y2);
+        latticeRange(std::min(bx, sx) - alienX, std::max(bx, sx) - alienX, f.pitchX, ALIEN_HALF_SIZE + SHOT_HALF_WIDTH, f.cols, x1, x2);
+
+        for (int r = y1; r <= y2; r++) {
+            for (int c = x1; c <= x2; c++) {
+                if (!f.get(r, c)) continue;
+
+                // alien bounding box
+                float ax = alienX + c * f.pitchX;
+                float ay = alienY - r * f.pitchY;
+                float alienLeft = ax - ALIEN_HALF_SIZE;
+                float alienRight = ax + ALIEN_HALF_SIZE;
+                float alienBottom = ay - ALIEN_HALF_SIZE;
+                float alienTop = ay + ALIEN_HALF_SIZE;
+
+                // bullet bounding box
+                float bulletLeft = bx - SHOT_HALF_WIDTH;
+                float bulletRight = bx + SHOT_HALF_WIDTH;
+                float bulletBottom = by - SHOT_HALF_HEIGHT;
+                float bulletTop = by + SHOT_HALF_HEIGHT;
+
+                // AABB collision check where the bullet ended up, then along its path
+                bool inside = bulletLeft < alienRight &&
+                    bulletRight > alienLeft &&
+                    bulletBottom < alienTop &&
+                    bulletTop > alienBottom;
+                float t;
+                if (!sweptEntry(bx, by, mx[i], my[i], alienLeft - SHOT_HALF_WIDTH, alienBottom - SHOT_HALF_HEIGHT,
+                        alienRight + SHOT_HALF_WIDTH, alienTop + SHOT_HALF_HEIGHT, t)) {
+                    if (!inside) continue;
+                    t = 1;
+                }
+                if (t < hitT) {
+                    hitT = t;
+                    hitR = r;
+                    hitC = c;
+                }
+            }
+        }
+
+        if (hitR >= 0) {
+            // destroy alien and bullet
+            f.kill(hitR, hitC);
+            onKill(alienX + hitC * f.pitchX, alienY - hitR * f.pitchY);
+            kills++;
+            keep[i] = 0;
+        }
+    }
+    return kills;
+}
+
+// uniform grid over the screen, rebuilt each tick with a counting sort;
+// points outside the screen are clamped into the border cells
+// (sized for the biggest pool so building it never allocates)
+struct pointGrid {
+    static const int MAX_POINTS = MAX_ALIEN_BULLETS;
+    static const int CELL = 50;
+    static const int COLS = WIDTH / CELL + 1;
+    static const int ROWS = HEIGHT / CELL + 1;
+    static const int MIN_POINTS = 64; // below this a straight scan is cheaper than building
+
+    int start[COLS * ROWS + 1];
+    int items[MAX_POINTS];  // point indices sorted by cell
+    int cellOf[MAX_POINTS];
+
+    static int cellX(float x) { return std::min(COLS - 1, std::max(0, (int)(x / CELL))); }
+    static int cellY(float y) { return std::min(ROWS - 1, std::max(0, (int)(y / CELL))); }
+
+    // px(i) / py(i) give the position of point i
+    template <typename PX, typename PY>
+    void build(int n, PX px, PY py) {
+        std::fill(start, start + COLS * ROWS + 1, 0);
+        for (int i = 0; i < n; i++) {
+            int c = cellY(py(i)) * COLS + cellX(px(i));
+            cellOf[i] = c;
+            start[c + 1]++;
+        }
+        for (int c = 0; c < COLS * ROWS; c++)
+            start[c + 1] += start[c];
+        // place using a running cursor per cell, then restore the starts
+        for (int i = 0; i < n; i++)
+            items[start[cellOf[i]]++] = i;
+        for (int c = COLS * ROWS; c > 0; c--)
+            start[c] = start[c - 1];
+        start[0] = 0;
+    }
+
+    // call fn(index) for every point in a cell touching [x1, x2] x [y1, y2]
+    template <typename F>
+    void query(float x1, float y1, float x2, float y2, F fn) const {
+        int cx1 = cellX(x1), cx2 = cellX(x2);
+        int cy1 = cellY(y1), cy2 = cellY(y2);
+        for (int cy = cy1; cy <= cy2; cy++)
+            for (int cx = cx1; cx <= cx2; cx++) {
+                int c = cy * COLS + cx;
+                for (int k = start[c]; k < start[c + 1]; k++)
+                    fn(items[k]);
+            }
+    }
+};
+
+// writes the indices (ascending) of the points for which inside(i) holds to
+// out and returns how many; only visits points in cells touching
+// [x1, x2] x [y1, y2] once the grid pays for itself. out needs room for n.
+template <typename PX, typename PY, typename F>
+int pointsInBox(pointGrid& grid, int n, PX px, PY py,
+    float x1, float y1, float x2, float y2, F inside, int* out) {
+    int found = 0;
+    if (n < pointGrid::MIN_POINTS) {
+        for (int i = 0; i < n; i++)
+            if (inside(i)) out[found++] = i;
+        return found;
+    }
+    grid.build(n, px, py);
+    grid.query(x1, y1, x2, y2, [&](int i) {
+        if (inside(i)) out[found++] = i;
+    });
+    std::sort(out, out + found);
+    return found;
+}
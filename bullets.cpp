@@ -0,0 +1,59 @@
+#include "bullets.h"
+#include "bits.h"
+#include "simd.h"
+
+void advanceBullets(int n, float* x, float* y, const float* dx, const float* dy, const float* speed, float dirY, float ticks) {
+    int i = 0;
+#ifdef SI_SSE2
+    const __m128 dir = _mm_set1_ps(dirY);
+    const __m128 scale = _mm_set1_ps(ticks);
+    for (; i + 4 <= n; i += 4) {
+        __m128 s = _mm_mul_ps(_mm_loadu_ps(speed + i), scale);
+        __m128 vx = _mm_mul_ps(_mm_loadu_ps(dx + i), s);
+        __m128 vy = _mm_mul_ps(_mm_mul_ps(dir, _mm_loadu_ps(dy + i)), s);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), vx));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), vy));
+    }
+#endif
+    for (; i < n; i++) {
+        float s = speed[i] * ticks;
+        x[i] += dx[i] * s;
+        y[i] += dirY * dy[i] * s;
+    }
+}
+
+// branch-free compaction: always write, only advance past kept bullets
+int compactBullets(int n, float* x, float* y, float* dx, float* dy, float* speed, const unsigned char* keep) {
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        x[k] = x[i];
+        y[k] = y[i];
+        dx[k] = dx[i];
+        dy[k] = dy[i];
+        speed[k] = speed[i];
+        k += keep[i] ? 1 : 0;
+    }
+    return k;
+}
+
+int markInside(int n, const float* y, float minY, float maxY, unsigned char* keep) {
+    int i = 0, kept = 0;
+#ifdef SI_SSE2
+    const __m128 lo = _mm_set1_ps(minY);
+    const __m128 hi = _mm_set1_ps(maxY);
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(y + i);
+        int out = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(v, lo), _mm_cmpgt_ps(v, hi)));
+        keep[i] = !(out & 1);
+        keep[i + 1] = !(out & 2);
+        keep[i + 2] = !(out & 4);
+        keep[i + 3] = !(out & 8);
+        kept += 4 - popcount64((unsigned)out);
+    }
+#endif
+    for (; i < n; i++) {
+        keep[i] = !(y[i] < minY || y[i] > maxY);
+        kept += keep[i];
+    }
+    return kept;
+}
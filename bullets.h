@@ -0,0 +1,65 @@
+#pragma once
+#include <cstring>
+
+// bullets stored as a structure of arrays. Each stream holds one kind of
+// bullet (straight player shots, homing shots, alien shots) so the per-tick
+// loops run over plain float arrays without branching on the bullet kind.
+// Capacity is fixed at compile time; removal compacts the arrays in place,
+// keeping the remaining bullets in order.
+
+// kernels shared by every stream size (bullets.cpp)
+void advanceBullets(int n, float* x, float* y, const float* dx, const float* dy, const float* speed, float dirY, float ticks);
+int compactBullets(int n, float* x, float* y, float* dx, float* dy, float* speed, const unsigned char* keep);
+int markInside(int n, const float* y, float minY, float maxY, unsigned char* keep); // returns how many are kept
+
+template <int N>
+struct bulletStream {
+    static const int CAPACITY = N;
+
+    int count = 0;
+    float x[N] = {}, y[N] = {};
+    float dx[N] = {}, dy[N] = {}; // unit direction, (0, 1) for straight shots
+    float speed[N] = {};
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    // false (and the shot is dropped) when the stream is full
+    bool push(float x_, float y_, float speed_, float dx_ = 0.0f, float dy_ = 1.0f) {
+        if (count == N) return false;
+        x[count] = x_;
+        y[count] = y_;
+        dx[count] = dx_;
+        dy[count] = dy_;
+        speed[count] = speed_;
+        count++;
+        return true;
+    }
+
+    // move every bullet by speed per tick along (dx, dirY * dy); dirY = 1 up, -1 down
+    void advance(float dirY, float ticks = 1.0f) { advanceBullets(count, x, y, dx, dy, speed, dirY, ticks); }
+
+    // how far bullet i moves in advance(dirY, ticks), for the swept collision tests
+    float moveX(int i, float ticks) const { return dx[i] * speed[i] * ticks; }
+    float moveY(int i, float dirY, float ticks) const { return dirY * dy[i] * speed[i] * ticks; }
+
+    // drop every bullet i with keep[i] == 0
+    void compact(const unsigned char* keep) { count = compactBullets(count, x, y, dx, dy, speed, keep); }
+
+    // become a copy of o, touching only its live bullets
+    void copyFrom(const bulletStream& o) {
+        count = o.count;
+        memcpy(x, o.x, sizeof(float) * count);
+        memcpy(y, o.y, sizeof(float) * count);
+        memcpy(dx, o.dx, sizeof(float) * count);
+        memcpy(dy, o.dy, sizeof(float) * count);
+        memcpy(speed, o.speed, sizeof(float) * count);
+    }
+
+    // drop bullets that left [minY, maxY] vertically
+    void cull(float minY, float maxY) {
+        unsigned char keep[N];
+        if (markInside(count, y, minY, maxY, keep) < count) compact(keep);
+    }
+};
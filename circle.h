@@ -0,0 +1,62 @@
+#pragma once
+
+// unit-circle vertex tables generated at compile time, one per segment count
+// used by the sprites, so no cos/sin is evaluated while drawing
+
+constexpr double CIRCLE_PI = 3.14159265358979323846;
+
+// taylor series, good to float precision on [-pi, pi]
+constexpr double constSin(double t) {
+    if (t > CIRCLE_PI) t -= 2 * CIRCLE_PI;
+    double term = t, sum = t;
+    for (int n = 1; n < 12; n++) {
+        term *= -t * t / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constCos(double t) {
+    return constSin(t + CIRCLE_PI / 2 > 2 * CIRCLE_PI ? t + CIRCLE_PI / 2 - 2 * CIRCLE_PI : t + CIRCLE_PI / 2);
+}
+
+template <int N>
+struct circleTable {
+    float x[N], y[N];
+
+    constexpr circleTable() : x(), y() {
+        for (int i = 0; i < N; i++) {
+            double theta = 2 * CIRCLE_PI * i / N;
+            x[i] = (float)constCos(theta);
+            y[i] = (float)constSin(theta);
+        }
+    }
+};
+
+template <int N>
+constexpr circleTable<N> unitCircle{};
+
+// vertex i of an n-segment unit circle is (xs[i], ys[i])
+struct circlePoints {
+    const float* xs;
+    const float* ys;
+};
+
+// segment counts the sprites use; returns false for anything else
+inline bool circleFor(int segments, circlePoints& out) {
+    switch (segments) {
+    case 8:  out = { unitCircle<8>.x,  unitCircle<8>.y };  return true;
+    case 12: out = { unitCircle<12>.x, unitCircle<12>.y }; return true;
+    case 14: out = { unitCircle<14>.x, unitCircle<14>.y }; return true;
+    case 16: out = { unitCircle<16>.x, unitCircle<16>.y }; return true;
+    case 18: out = { unitCircle<18>.x, unitCircle<18>.y }; return true;
+    case 20: out = { unitCircle<20>.x, unitCircle<20>.y }; return true;
+    case 24: out = { unitCircle<24>.x, unitCircle<24>.y }; return true;
+    case 32: out = { unitCircle<32>.x, unitCircle<32>.y }; return true;
+    case 64: out = { unitCircle<64>.x, unitCircle<64>.y }; return true;
+    }
+    return false;
+}
+
+static_assert(unitCircle<4>.x[1] < 1e-6f && unitCircle<4>.x[1] > -1e-6f, "cos(pi/2) should be 0");
+static_assert(unitCircle<4>.y[1] > 0.999999f, "sin(pi/2) should be 1");
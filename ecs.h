@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+
+// minimal entity-component storage. Everything is fixed capacity and lives
+// inline in its owner, so a game holding it stays trivially copyable for
+// snapshots and rewind, and nothing allocates during play.
+typedef uint16_t entity;
+const entity NO_ENTITY = 0xffff;
+
+// entity ids in [0, N); destroyed ids are reused
+template <int N>
+struct entityPool {
+    static_assert(N < NO_ENTITY, "entity ids must fit below NO_ENTITY");
+
+    int issued = 0; // ids [0, issued) have been handed out at some point
+    int freeCount = 0;
+    entity freeIds[N] = {};
+
+    // NO_ENTITY when all N are in use
+    entity create() {
+        if (freeCount > 0) return freeIds[--freeCount];
+        if (issued == N) return NO_ENTITY;
+        return (entity)issued++;
+    }
+    void destroy(entity e) { freeIds[freeCount++] = e; }
+    void clear() { issued = freeCount = 0; }
+};
+
+// one component type: values packed densely (removal moves the last one into
+// the hole, so order is not kept) plus an entity -> slot index. Systems loop
+// over items[0, size()) and use owner[] to reach the entity's other components.
+template <typename T, int N, int ENTITIES>
+struct componentStore {
+    static const int CAPACITY = N;
+
+    int count = 0;
+    T items[N] = {};
+    entity owner[N] = {};
+    uint16_t slotOf[ENTITIES] = {}; // slot + 1, 0 = entity has no such component
+
+    int size() const { return count; }
+    bool full() const { return count == N; }
+    bool has(entity e) const { return slotOf[e] != 0; }
+
+    T* get(entity e) { return slotOf[e] ? &items[slotOf[e] - 1] : nullptr; }
+    const T* get(entity e) const { return slotOf[e] ? &items[slotOf[e] - 1] : nullptr; }
+
+    // false (and nothing added) when full or e already has one
+    bool add(entity e, const T& v) {
+        if (count == N || slotOf[e]) return false;
+        items[count] = v;
+        owner[count] = e;
+        slotOf[e] = (uint16_t)++count;
+        return true;
+    }
+
+    void remove(entity e) {
+        int i = slotOf[e] - 1;
+        if (i < 0) return;
+        int last = --count;
+        items[i] = items[last];
+        owner[i] = owner[last];
+        slotOf[owner[i]] = (uint16_t)(i + 1);
+        slotOf[e] = 0;
+    }
+
+    void clear() {
+        for (int i = 0; i < count; i++) slotOf[owner[i]] = 0;
+        count = 0;
+    }
+
+    T& operator[](int i) { return items[i]; }
+    const T& operator[](int i) const { return items[i]; }
+};
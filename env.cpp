@@ -0,0 +1,190 @@
+#include "env.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "replay.h"
+#include "sim.h"
+
+struct si_env {
+    int count = 0;
+    int rows = 0, cols = 0;
+    std::vector<game> games;
+    std::vector<float> rewards;
+
+    // caller-owned observation buffers
+    float* features = nullptr;
+    unsigned char* raster = nullptr;
+    int width = 0, height = 0;
+};
+
+static int featureSize(const si_env* env) {
+    return SI_FEAT_ALIVE + env->rows * env->cols;
+}
+
+static float remaining(const game& g, int kind) {
+    int full = g.effectTicks[kind];
+    return g.effectActive(kind) && full > 0 ? (float)g.effectTimer[kind] / full : 0.0f;
+}
+
+static void writeFeatures(const game& g, float* out) {
+    out[SI_FEAT_PLAYER_X] = g.playerX / WIDTH;
+    out[SI_FEAT_ALIEN_X] = g.alienX / WIDTH;
+    out[SI_FEAT_ALIEN_Y] = g.alienY / HEIGHT;
+    out[SI_FEAT_ALIEN_DIR] = g.aliensRight ? 1.0f : -1.0f;
+    out[SI_FEAT_ALIEN_SPEED] = g.alienSpeed / 10;
+    out[SI_FEAT_ROUND] = std::min(1.0f, (float)g.round / finalRound(g));
+    out[SI_FEAT_SLOW] = remaining(g, POWERUP_SLOW);
+    out[SI_FEAT_HOMING] = remaining(g, POWERUP_HOMING);
+    out[SI_FEAT_SHIELD] = remaining(g, POWERUP_SHIELD);
+
+    // closest alien bullets, kept sorted by insertion since K is tiny
+    const int K = SI_NEAREST_BULLETS;
+    float bestD[K], bestX[K], bestY[K];
+    int found = 0;
+    const auto& ab = g.alienBullets;
+    for (int i = 0; i < ab.size(); i++) {
+        float dx = ab.x[i] - g.playerX, dy = ab.y[i] - 35;
+        float d = dx * dx + dy * dy;
+        if (found == K && d >= bestD[K - 1]) continue;
+        int k = found < K ? found++ : K - 1;
+        for (; k > 0 && bestD[k - 1] > d; k--) {
+            bestD[k] = bestD[k - 1];
+            bestX[k] = bestX[k - 1];
+            bestY[k] = bestY[k - 1];
+        }
+        bestD[k] = d;
+        bestX[k] = dx;
+        bestY[k] = dy;
+    }
+    float* b = out + SI_FEAT_BULLETS;
+    for (int k = 0; k < K; k++) {
+        b[3 * k] = k < found ? bestX[k] / WIDTH : 0.0f;
+        b[3 * k + 1] = k < found ? bestY[k] / HEIGHT : 0.0f;
+        b[3 * k + 2] = k < found ? 1.0f : 0.0f;
+    }
+
+    const formation& f = g.aliens;
+    float* alive = out + SI_FEAT_ALIVE;
+    for (int y = 0; y < f.rows; y++)
+        for (int x = 0; x < f.cols; x++)
+            alive[y * f.cols + x] = f.get(y, x) ? 1.0f : 0.0f;
+}
+
+// fill the world-space box [x1, x2] x [y1, y2] (y up) at least one pixel big
+static void fillBox(unsigned char* img, int w, int h, float x1, float y1, float x2, float y2, unsigned char v) {
+    // nothing for boxes wholly off screen, clamping them would draw a ghost on the edge
+    if (x2 < 0 || x1 >= WIDTH || y2 < 0 || y1 >= HEIGHT) return;
+    float sx = (float)w / WIDTH, sy = (float)h / HEIGHT;
+    int c1 = std::max(0, (int)(x1 * sx)), c2 = std::min(w - 1, std::max(c1, (int)(x2 * sx)));
+    int r1 = std::max(0, (int)((HEIGHT - y2) * sy)), r2 = std::min(h - 1, std::max(r1, (int)((HEIGHT - y1) * sy)));
+    for (int r = r1; r <= r2; r++)
+        memset(img + r * w + c1, v, c2 >= c1 ? c2 - c1 + 1 : 0);
+}
+
+static void writeRaster(const game& g, unsigned char* img, int w, int h) {
+    memset(img, 0, (size_t)w * h);
+
+    const formation& f = g.aliens;
+    f.forEach([&](int y, int x) {
+        float ax = g.alienX + x * f.pitchX, ay = g.alienY - y * f.pitchY;
+        fillBox(img, w, h, ax - 15, ay - 15, ax + 15, ay + 15, 160);
+    });
+    for (int i = 0; i < g.pickups.size(); i++) {
+        const position* p = g.positions.get(g.pickups.owner[i]);
+        fillBox(img, w, h, p->x - 10, p->y - 10, p->x + 10, p->y + 10, 224);
+    }
+    for (int i = 0; i < g.playerBullets.size(); i++)
+        fillBox(img, w, h, g.playerBullets.x[i] - 2, g.playerBullets.y[i] - 8, g.playerBullets.x[i] + 2, g.playerBullets.y[i] + 8, 64);
+    for (int i = 0; i < g.homingBullets.size(); i++)
+        fillBox(img, w, h, g.homingBullets.x[i] - 2, g.homingBullets.y[i] - 8, g.homingBullets.x[i] + 2, g.homingBullets.y[i] + 8, 64);
+    for (int i = 0; i < g.alienBullets.size(); i++)
+        fillBox(img, w, h, g.alienBullets.x[i] - 2, g.alienBullets.y[i] - 8, g.alienBullets.x[i] + 2, g.alienBullets.y[i] + 8, 96);
+    fillBox(img, w, h, g.playerX - 20, 20, g.playerX + 20, 50, 255);
+}
+
+static void observe(si_env* env, int i) {
+    if (env->features) writeFeatures(env->games[i], env->features + (size_t)i * featureSize(env));
+    if (env->raster) writeRaster(env->games[i], env->raster + (size_t)i * env->width * env->height, env->width, env->height);
+}
+
+static void stepGame(si_env* env, int i, unsigned char action) {
+    game& g = env->games[i];
+    if (g.gameOver) {
+        env->rewards[i] = 0;
+        return;
+    }
+    // agents only move and shoot; pausing and restarting go through si_reset
+    int score = g.score;
+    step(g, unpackInput(action & (SI_ACTION_LEFT | SI_ACTION_RIGHT | SI_ACTION_FIRE)));
+    env->rewards[i] = (float)(g.score - score);
+    observe(env, i);
+}
+
+si_env* si_create(int count, int rows, int cols) {
+    if (count < 1) return nullptr;
+    si_env* env = new si_env;
+    env->count = count;
+    env->games.resize(count);
+    env->rewards.assign(count, 0.0f);
+    for (game& g : env->games) {
+        g.waveRows = rows;
+        g.waveCols = cols;
+        resetGame(g);
+    }
+    // the formation clamps out-of-range sizes, report what it really uses
+    env->rows = env->games[0].aliens.rows;
+    env->cols = env->games[0].aliens.cols;
+    return env;
+}
+
+void si_destroy(si_env* env) {
+    delete env;
+}
+
+int si_feature_size(const si_env* env) {
+    return featureSize(env);
+}
+
+void si_set_observation(si_env* env, float* features, unsigned char* raster, int width, int height) {
+    env->features = features;
+    env->raster = raster && width > 0 && height > 0 ? raster : nullptr;
+    env->width = width;
+    env->height = height;
+    for (int i = 0; i < env->count; i++) observe(env, i);
+}
+
+void si_reset(si_env* env, int index, uint64_t seed) {
+    game& g = env->games[index];
+    seedGame(g, seed);
+    resetGame(g);
+    env->rewards[index] = 0;
+    observe(env, index);
+}
+
+void si_reset_all(si_env* env, uint64_t seed) {
+    for (int i = 0; i < env->count; i++) si_reset(env, i, seed + i);
+}
+
+void si_step(si_env* env, const unsigned char* actions, float* rewards, unsigned char* dones) {
+    for (int i = 0; i < env->count; i++) {
+        stepGame(env, i, actions[i]);
+        if (rewards) rewards[i] = env->rewards[i];
+        if (dones) dones[i] = env->games[i].gameOver ? 1 : 0;
+    }
+}
+
+void si_step_one(si_env* env, int index, unsigned char action) {
+    stepGame(env, index, action);
+}
+
+float si_reward(const si_env* env, int index) {
+    return env->rewards[index];
+}
+
+int si_done(const si_env* env, int index) {
+    return env->games[index].gameOver ? 1 : 0;
+}
+
+int si_end_reason(const si_env* env, int index) {
+    return (int)env->games[index].ended;
+}
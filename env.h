@@ -0,0 +1,89 @@
+#pragma once
+/* reinforcement-learning environment: a C API over the headless simulation,
+   built as a shared library (space-invaders-env). One handle holds a batch of
+   independent games; observations are written straight into buffers the
+   caller registers once, nothing is returned by copy.
+
+   Typical loop:
+       si_env* env = si_create(64, 4, 8);
+       si_set_observation(env, features, raster, 84, 84);
+       si_reset_all(env, seed);
+       for (;;) si_step(env, actions, rewards, dones);
+
+   A handle must only be used from one thread at a time; separate handles on
+   separate threads are independent. */
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(SI_ENV_BUILD)
+#define SI_API __declspec(dllexport)
+#else
+#define SI_API __declspec(dllimport)
+#endif
+#else
+#define SI_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* action bits (same layout as recorded replay inputs) */
+enum {
+    SI_ACTION_LEFT = 1,
+    SI_ACTION_RIGHT = 2,
+    SI_ACTION_FIRE = 4,
+};
+
+/* feature vector layout, all values roughly in [-1, 1] */
+enum {
+    SI_FEAT_PLAYER_X = 0,    /* player x / screen width */
+    SI_FEAT_ALIEN_X = 1,     /* formation anchor x / screen width */
+    SI_FEAT_ALIEN_Y = 2,     /* formation anchor y / screen height */
+    SI_FEAT_ALIEN_DIR = 3,   /* +1 moving right, -1 moving left */
+    SI_FEAT_ALIEN_SPEED = 4, /* pixels per tick / 10 */
+    SI_FEAT_ROUND = 5,       /* round / last round (wave table length or built-in) */
+    SI_FEAT_SLOW = 6,        /* remaining fraction of each power-up, 0 when off */
+    SI_FEAT_HOMING = 7,
+    SI_FEAT_SHIELD = 8,
+    SI_FEAT_BULLETS = 9,     /* SI_NEAREST_BULLETS x (dx, dy, present) of the closest
+                                alien bullets relative to the player, nearest first */
+    SI_NEAREST_BULLETS = 8,
+    SI_FEAT_ALIVE = SI_FEAT_BULLETS + 3 * SI_NEAREST_BULLETS, /* rows x cols, 1 = alive, row-major */
+};
+
+typedef struct si_env si_env;
+
+/* count games with a rows x cols formation; NULL if count < 1 */
+SI_API si_env* si_create(int count, int rows, int cols);
+SI_API void si_destroy(si_env* env);
+
+/* floats per game in the feature buffer: SI_FEAT_ALIVE + rows * cols */
+SI_API int si_feature_size(const si_env* env);
+
+/* where observations go: features needs count * si_feature_size() floats,
+   raster (optional, NULL to skip) count * width * height bytes, one
+   grayscale image per game with row 0 at the top of the screen */
+SI_API void si_set_observation(si_env* env, float* features, unsigned char* raster, int width, int height);
+
+/* start game `index` (or every game, game i seeded with seed + i) */
+SI_API void si_reset(si_env* env, int index, uint64_t seed);
+SI_API void si_reset_all(si_env* env, uint64_t seed);
+
+/* advance every game one tick; actions[i] drives game i. Finished games stay
+   put (reward 0) until they are reset. rewards / dones may be NULL. */
+SI_API void si_step(si_env* env, const unsigned char* actions, float* rewards, unsigned char* dones);
+
+/* advance only game `index` */
+SI_API void si_step_one(si_env* env, int index, unsigned char action);
+
+/* score gained on the last step, and whether the game has ended */
+SI_API float si_reward(const si_env* env, int index);
+SI_API int si_done(const si_env* env, int index);
+
+/* how the game ended: 0 still running, 1 invaded, 2 shot, 3 cleared */
+SI_API int si_end_reason(const si_env* env, int index);
+
+#ifdef __cplusplus
+}
+#endif
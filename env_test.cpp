@@ -0,0 +1,58 @@
+// RL environment check: a game reset with a seed must play exactly like a
+// brand new one reset with the same seed, however much it played before
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "env.h"
+
+// a fixed action for tick t: wander left and right, shooting most ticks, so
+// games pick up power-ups and leave bullets and pickups behind
+static unsigned char action(long long t) {
+    unsigned char a = (t / 90) % 2 ? SI_ACTION_LEFT : SI_ACTION_RIGHT;
+    if (t % 3 == 0) a |= SI_ACTION_FIRE;
+    return a;
+}
+
+int main() {
+    si_env* used = si_create(1, 4, 8);
+    si_env* fresh = si_create(1, 4, 8);
+    int size = si_feature_size(used);
+    std::vector<float> usedFeatures(size), freshFeatures(size);
+    si_set_observation(used, usedFeatures.data(), nullptr, 0, 0);
+    si_set_observation(fresh, freshFeatures.data(), nullptr, 0, 0);
+
+    // wear the first env in: 40 games, each cut off mid-play or played out
+    si_reset(used, 0, 1);
+    long long t = 0;
+    for (int games = 0; games < 40; t++) {
+        si_step_one(used, 0, action(t));
+        if (si_done(used, 0) || t % 5000 == 4999) si_reset(used, 0, 2 + games++);
+    }
+    // and stop it partway into a game, with whatever is on screen left there
+    for (int i = 0; i < 700; i++, t++) si_step_one(used, 0, action(t));
+
+    si_reset(used, 0, 7);
+    si_reset(fresh, 0, 7);
+    int failures = 0;
+    for (int tick = 0; tick < 20000 && !failures; tick++) {
+        for (int k = 0; k < size; k++) {
+            if (usedFeatures[k] != freshFeatures[k]) {
+                printf("tick %d: feature %d is %g after reuse, %g fresh\n", tick, k, usedFeatures[k], freshFeatures[k]);
+                failures++;
+                break;
+            }
+        }
+        if (si_reward(used, 0) != si_reward(fresh, 0) || si_done(used, 0) != si_done(fresh, 0)) {
+            printf("tick %d: reward or done differs after reuse\n", tick);
+            failures++;
+        }
+        if (si_done(fresh, 0)) break;
+        si_step_one(used, 0, action(tick));
+        si_step_one(fresh, 0, action(tick));
+    }
+
+    si_destroy(used);
+    si_destroy(fresh);
+    printf("reused env after reset: %s\n", failures ? "DIFFERS" : "same as a fresh one");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+#include "formation.h"
+
+void formation::reset(int rows_, int cols_) {
+    rows = rows_ < 1 ? 1 : rows_ > MAX_FORMATION_ROWS ? MAX_FORMATION_ROWS : rows_;
+    cols = cols_ < 1 ? 1 : cols_ > MAX_FORMATION_COLS ? MAX_FORMATION_COLS : cols_;
+
+    uint64_t rowBits = cols == 64 ? ~0ull : (1ull << cols) - 1;
+    uint64_t colBits = rows == 64 ? ~0ull : (1ull << rows) - 1;
+    for (int y = 0; y < MAX_FORMATION_ROWS; y++) row[y] = y < rows ? rowBits : 0;
+    for (int x = 0; x < MAX_FORMATION_COLS; x++) col[x] = x < cols ? colBits : 0;
+    rowMask = colBits;
+    colMask = rowBits;
+    alive = rows * cols;
+}
+
+void formation::kill(int y, int x) {
+    if (!get(y, x)) return;
+    row[y] &= ~(1ull << x);
+    col[x] &= ~(1ull << y);
+    if (!row[y]) rowMask &= ~(1ull << y);
+    if (!col[x]) colMask &= ~(1ull << x);
+    alive--;
+}
+
+void formation::nth(int k, int& y, int& x) const {
+    for (uint64_t rows = rowMask; rows; rows &= rows - 1) {
+        int r = lowestBit(rows);
+        int n = popcount64(row[r]);
+        if (k < n) {
+            y = r;
+            x = selectBit(row[r], k);
+            return;
+        }
+        k -= n;
+    }
+    y = x = -1;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include "bits.h"
+
+// biggest formation a wave can use (one 64-bit word per row / column)
+const int MAX_FORMATION_ROWS = 64;
+const int MAX_FORMATION_COLS = 64;
+
+// alien formation as a bitboard: row[y] bit x and its transpose col[x] bit y
+// are set while the alien at (row y, col x) is alive. Occupancy masks and the
+// alive count are kept up to date on every kill, so edge/bottom/random-pick
+// queries are a few popcount/bit scans instead of walking the whole grid.
+struct formation {
+    int rows = 0, cols = 0;
+    float pitchX = 60, pitchY = 40; // spacing between aliens
+
+    uint64_t row[MAX_FORMATION_ROWS] = {};
+    uint64_t col[MAX_FORMATION_COLS] = {};
+    uint64_t rowMask = 0; // bit y set if row y has any alien alive
+    uint64_t colMask = 0; // bit x set if column x has any alien alive
+    int alive = 0;
+
+    // resize and bring every alien back to life
+    void reset(int rows, int cols);
+
+    bool get(int y, int x) const { return (row[y] >> x) & 1; }
+    void kill(int y, int x);
+
+    bool empty() const { return alive == 0; }
+    int leftColumn() const { return lowestBit(colMask); }   // formation must not be empty
+    int rightColumn() const { return highestBit(colMask); }
+    int bottomRow() const { return highestBit(rowMask); }
+
+    // k-th alive alien in row-major order (0 <= k < alive)
+    void nth(int k, int& y, int& x) const;
+
+    // call fn(y, x) for every alive alien in row-major order
+    template <typename F>
+    void forEach(F fn) const {
+        for (uint64_t rows = rowMask; rows; rows &= rows - 1) {
+            int y = lowestBit(rows);
+            for (uint64_t bits = row[y]; bits; bits &= bits - 1)
+                fn(y, lowestBit(bits));
+        }
+    }
+};
@@ -0,0 +1,65 @@
+#include "geometry.h"
+#include <cassert>
+#include <cmath>
+#include "circle.h"
+
+void mesh::color(float r, float g, float b, float a) {
+    cr = r; cg = g; cb = b; ca = a;
+}
+
+void mesh::triangle(float x1, float y1, float x2, float y2, float x3, float y3) {
+    tris.push_back({ x1, y1, cr, cg, cb, ca });
+    tris.push_back({ x2, y2, cr, cg, cb, ca });
+    tris.push_back({ x3, y3, cr, cg, cb, ca });
+}
+
+void mesh::polygon(std::initializer_list<float> xy) {
+    // fan from the first vertex, which is what GL_POLYGON does for convex shapes
+    const float* p = xy.begin();
+    int n = (int)xy.size() / 2;
+    for (int i = 1; i + 1 < n; i++)
+        triangle(p[0], p[1], p[i * 2], p[i * 2 + 1], p[i * 2 + 2], p[i * 2 + 3]);
+}
+
+void mesh::ellipse(float cx, float cy, float rx, float ry, int segments, int count) {
+    circlePoints c;
+    bool known = circleFor(segments, c);
+    assert(known && "add the segment count to circleFor()");
+    if (!known) return;
+
+    if (count <= 0 || count > segments) count = segments;
+    float x0 = cx + c.xs[0] * rx, y0 = cy + c.ys[0] * ry;
+    for (int i = 2; i < count; ++i) {
+        triangle(x0, y0,
+            cx + c.xs[i - 1] * rx, cy + c.ys[i - 1] * ry,
+            cx + c.xs[i] * rx, cy + c.ys[i] * ry);
+    }
+}
+
+void mesh::line(float x1, float y1, float x2, float y2) {
+    float dx = x2 - x1, dy = y2 - y1;
+    float len = sqrt(dx * dx + dy * dy);
+    if (len <= 0.0f) return;
+    float nx = -dy / len * 0.5f, ny = dx / len * 0.5f;
+    triangle(x1 + nx, y1 + ny, x1 - nx, y1 - ny, x2 - nx, y2 - ny);
+    triangle(x1 + nx, y1 + ny, x2 - nx, y2 - ny, x2 + nx, y2 + ny);
+}
+
+void batch::add(const mesh& m, float x, float y, float scale, float c, float s,
+    float tr, float tg, float tb, float ta) {
+    float sc = c * scale, ss = s * scale;
+    for (const vertex& v : m.tris) {
+        verts.push_back({
+            x + sc * v.x - ss * v.y,
+            y + ss * v.x + sc * v.y,
+            v.r * tr, v.g * tg, v.b * tb, v.a * ta
+            });
+    }
+}
+
+void batch::triangle(float x1, float y1, float x2, float y2, float x3, float y3,
+    float r, float g, float b, float a) {
+    verts.push_back({ x1, y1, r, g, b, a });
+    verts.push_back({ x2, y2, r, g, b, a });
+    verts.push_back({ x3, y3, r, g, b, a });
+}
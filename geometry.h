@@ -0,0 +1,48 @@
+#pragma once
+#include <initializer_list>
+#include <vector>
+
+// a vertex as it is handed to the renderer: position + color
+struct vertex {
+    float x, y;
+    float r, g, b, a;
+};
+
+// a sprite's triangles in local coordinates, built once at startup
+struct mesh {
+    std::vector<vertex> tris;
+
+    // color used for everything added after this call
+    void color(float r, float g, float b, float a = 1.0f);
+
+    void triangle(float x1, float y1, float x2, float y2, float x3, float y3);
+
+    // convex polygon given as x,y pairs (same winding as the old GL_POLYGON calls)
+    void polygon(std::initializer_list<float> xy);
+
+    // ellipse from the precomputed unit circle with the given number of segments;
+    // count < segments keeps only the first count vertices (an arc)
+    void ellipse(float cx, float cy, float rx, float ry, int segments, int count = 0);
+
+    // 1px line, stored as a thin quad so everything stays in one triangle list
+    void line(float x1, float y1, float x2, float y2);
+
+private:
+    float cr = 1.0f, cg = 1.0f, cb = 1.0f, ca = 1.0f;
+};
+
+// vertices collected over a frame and submitted with a single draw call
+// (renderer::triangles)
+struct batch {
+    std::vector<vertex> verts;
+
+    void clear() { verts.clear(); }
+
+    // add a mesh instance: rotated by (c, s), scaled, moved to (x, y) and color-multiplied by the tint
+    void add(const mesh& m, float x, float y, float scale = 1.0f, float c = 1.0f, float s = 0.0f,
+        float tr = 1.0f, float tg = 1.0f, float tb = 1.0f, float ta = 1.0f);
+
+    // one-off triangle for geometry that changes every frame
+    void triangle(float x1, float y1, float x2, float y2, float x3, float y3,
+        float r, float g, float b, float a = 1.0f);
+};
@@ -0,0 +1,43 @@
+#include "glrender.h"
+#include <GL/glut.h>
+#include "sim.h"
+
+void glRenderer::init() {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluOrtho2D(0, WIDTH, 0, HEIGHT);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    font18.build(GLUT_BITMAP_HELVETICA_18);
+    font12.build(GLUT_BITMAP_HELVETICA_12);
+}
+
+void glRenderer::clear() {
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void glRenderer::triangles(const vertex* v, int count) {
+    if (count == 0) return;
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(vertex), &v[0].x);
+    glColorPointer(4, GL_FLOAT, sizeof(vertex), &v[0].r);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)count);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void glRenderer::text(int slot, const char* s, float x, float y, int size, float r, float g, float b) {
+    const glyphFont& f = size >= 18 ? font18 : font12;
+    if (slot < 0 || slot >= TEXT_SLOTS) {
+        glColor3f(r, g, b);
+        f.draw(s, x, y);
+        return;
+    }
+    // set() is a no-op while the line is unchanged, so this is just the list replay
+    lines[slot].set(f, s, x, y, r, g, b);
+    lines[slot].draw();
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "render.h"
+#include "text.h"
+
+// renderer for the game window: triangles go out as one vertex-array draw
+// call, text through GLUT bitmap fonts with each slot cached in a display list
+struct glRenderer : renderer {
+    // needs a current GL context; sets up the projection and blending
+    void init();
+
+    void clear() override;
+    void triangles(const vertex* v, int count) override;
+    void text(int slot, const char* s, float x, float y, int size,
+        float r = 1.0f, float g = 1.0f, float b = 1.0f) override;
+
+private:
+    glyphFont font18, font12;
+    textLine lines[TEXT_SLOTS];
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// lock-free handoffs between exactly one writer thread and one reader thread
+
+// triple buffer: the writer fills back() and publish()es it, the reader calls
+// update() and then reads front(), which is always the newest complete slot.
+// Neither side ever waits; a slot published before the reader picked up the
+// previous one simply replaces it.
+template <typename T>
+struct tripleBuffer {
+    // writer side
+    T& back() { return slots[backSlot]; }
+    void publish() { backSlot = middle.exchange(backSlot | FRESH, std::memory_order_acq_rel) & SLOT; }
+
+    // reader side: swap in the newest published slot, false if there was none
+    bool update() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        frontSlot = middle.exchange(frontSlot, std::memory_order_acq_rel) & SLOT;
+        return true;
+    }
+    const T& front() const { return slots[frontSlot]; }
+
+private:
+    static const int SLOT = 3, FRESH = 4; // middle holds a slot index plus a "not read yet" bit
+
+    T slots[3];
+    int backSlot = 0;                  // writer only
+    alignas(64) std::atomic<int> middle{ 1 };
+    alignas(64) int frontSlot = 2;     // reader only
+};
+
+// bounded single-producer single-consumer ring; push() fails when full
+template <typename T, int N>
+struct spscQueue {
+    static_assert((N & (N - 1)) == 0, "queue size must be a power of two");
+
+    bool push(const T& v) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == (size_t)N) return false;
+        items[h & (N - 1)] = v;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        v = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+private:
+    T items[N];
+    alignas(64) std::atomic<size_t> head{ 0 }; // written by the producer
+    alignas(64) std::atomic<size_t> tail{ 0 }; // written by the consumer
+};
@@ -0,0 +1,342 @@
+// headless runner: steps the simulation as fast as possible, no window needed
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "alloc_counter.h"
+#include "bot.h"
+#include "lanes.h"
+#include "profiler.h"
+#include "replay.h"
+#include "sim.h"
+#include "snapshot.h"
+#include "waves.h"
+
+// re-simulate a recorded session and print where it ended up; with stepTicks
+// above 1, a tick and the held input after it go through step() up to
+// stepTicks ticks at a time
+static int playReplay(const char* path, const waveFile& waves, int stepTicks) {
+    replay r;
+    if (!r.load(path)) {
+        printf("could not read replay %s\n", path);
+        return 1;
+    }
+
+    game g;
+    waves.use(g);
+    if (const char* why = r.checkWaves(g)) {
+        printf("can't play replay %s: %s\n", path, why);
+        return 1;
+    }
+    r.start(g);
+    size_t steps = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < r.inputs.size(); steps++) {
+        input in = unpackInput(r.inputs[t]);
+        int run = 1;
+        while (run < stepTicks && t + run < r.inputs.size() && heldInput(in, unpackInput(r.inputs[t + run]))) run++;
+        step(g, in, run);
+        t += run;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double secs = std::chrono::duration<double>(end - start).count();
+    double ticks = (double)r.inputs.size();
+    printf("ticks: %zu (%.1f s of play) in %zu steps\n", r.inputs.size(), ticks / TICK_RATE, steps);
+    printf("score: %d\n", g.score);
+    printf("round: %d\n", g.round);
+    printf("shots: %d hits: %d\n", g.totalShots, g.hits);
+    printf("game over: %s\n", g.gameOver ? "yes" : "no");
+    printf("time: %.3f s (%.0fx real time)\n", secs, secs > 0 ? ticks / TICK_RATE / secs : 0.0);
+    return 0;
+}
+
+// the --sweep-check game, a tick per step() or ticks ticks per step(): the
+// formation marches, turns and fires as usual and drops power-ups, the
+// player sweeps back and forth shooting every `every` ticks (homing shots on
+// the first pass), then stands under three fast aimed shots (one wide either
+// side, then one on target) that cross the player box in less than a long step
+static game sweepGame(unsigned long long seed, int every, int ticks) {
+    game g;
+    seedGame(g, seed);
+    g.waveRows = 5;
+    g.waveCols = 12;
+    g.alienFireOdds = 10;
+    resetGame(g);
+
+    const long long pass = every * 24LL; // ticks per sweep, about one screen width
+    const long long sweeping = pass * 2;
+    const long long spacing = (60 + every - 1) / every * every; // between the aimed shots, time to land
+    const float offsets[3] = { -40, 40, 0 };
+    g.effectTimer[POWERUP_HOMING] = (int)pass;
+    for (long long t = 0; t < sweeping + spacing * 4 && !g.gameOver; t += ticks) {
+        input in;
+        if (t < sweeping) {
+            in.right = t / pass == 0;
+            in.left = !in.right;
+            in.fire = t % every == 0;
+        }
+        else if ((t - sweeping) % spacing == 0) {
+            // 12 px per tick, well past the player box's 30 px height in one long step
+            if (t - sweeping < spacing * 3) g.alienBullets.push(g.playerX + offsets[(t - sweeping) / spacing], 400, 12.0f);
+        }
+        step(g, in, ticks);
+    }
+    return g;
+}
+
+// play the sweep-check game at 1 tick and at ticks ticks per step() and check
+// they ended up in the same place; only the alien shots' positions may be
+// off by float rounding, so those are compared by count
+static int sweepCheck(unsigned long long seed, int ticks) {
+    game fine = sweepGame(seed, ticks, 1);
+    game coarse = sweepGame(seed, ticks, ticks);
+
+    bool same = fine.score == coarse.score && fine.hits == coarse.hits && fine.totalShots == coarse.totalShots &&
+        fine.gameOver == coarse.gameOver && fine.ended == coarse.ended && fine.round == coarse.round &&
+        fine.playerX == coarse.playerX && fine.alienX == coarse.alienX && fine.alienY == coarse.alienY &&
+        fine.aliens.alive == coarse.aliens.alive &&
+        std::equal(fine.aliens.row, fine.aliens.row + MAX_FORMATION_ROWS, coarse.aliens.row) &&
+        fine.random.state == coarse.random.state &&
+        std::equal(fine.effectTimer, fine.effectTimer + POWERUP_KINDS, coarse.effectTimer) &&
+        fine.pickups.size() == coarse.pickups.size() && fine.alienBullets.size() == coarse.alienBullets.size() &&
+        fine.homingBullets.size() == coarse.homingBullets.size() && fine.playerBullets.size() == coarse.playerBullets.size();
+    const char* endings[] = { "still playing", "invaded", "player shot", "cleared" };
+    for (const game* g : { &fine, &coarse }) {
+        printf("%-7s score %d, %d of %d shots hit, round %d, %d alien shots left, %s\n", g == &fine ? "1 tick:" : "long:",
+            g->score, g->hits, g->totalShots, g->round, g->alienBullets.size(), endings[g->ended]);
+    }
+    printf("steps of %d ticks: match: %s\n", ticks, same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
+
+// run LANES scripted games set up like config through the lane kernel, then
+// the same games one at a time through step(), and check they ended up
+// identical; fireEvery above 0 overrides the script's fire rate
+static int runWorlds(long long ticks, unsigned long long seed, const game& config, int fireEvery) {
+    if (const char* why = checkWorlds(config)) {
+        printf("can't run these games in lanes: %s\n", why);
+        return 1;
+    }
+    static worlds w;
+    setupWorlds(w, config);
+    for (int l = 0; l < LANES; l++) {
+        seedWorld(w, l, seed + l);
+        resetWorld(w, l);
+    }
+
+    // each lane runs the script at a different phase so they don't move in step
+    const long long phase = 37;
+    auto script = [fireEvery](bool gameOver, long long t) {
+        input in = scriptedInput(gameOver, t);
+        if (fireEvery > 0) in.fire = t % fireEvery == 0;
+        return in;
+    };
+    input in[LANES];
+    auto start = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; t++) {
+        for (int l = 0; l < LANES; l++) in[l] = script(w.gameOver[l], t + l * phase);
+        stepWorlds(w, in);
+    }
+    auto mid = std::chrono::steady_clock::now();
+
+    static game g[LANES];
+    for (int l = 0; l < LANES; l++) {
+        g[l] = config;
+        seedGame(g[l], seed + l);
+        resetGame(g[l]);
+        for (long long t = 0; t < ticks; t++)
+            step(g[l], script(g[l].gameOver, t + l * phase));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    int mismatches = 0;
+    for (int l = 0; l < LANES; l++) {
+        const game& s = g[l];
+        if (s.score != w.score[l] || s.round != w.round[l] || s.hits != w.hits[l] || s.totalShots != w.totalShots[l] ||
+            s.playerX != w.playerX[l] || s.alienX != w.alienX[l] || s.alienY != w.alienY[l] ||
+            s.gameOver != w.gameOver[l] || s.ended != w.ended[l] || s.aliens.alive != w.aliens[l].alive ||
+            s.playerBullets.size() != w.playerBullets[l].size() || s.alienBullets.size() != w.alienBullets[l].size() ||
+            s.random.state != w.random[l].state) {
+            printf("lane %d differs: score %d vs %d, round %d vs %d\n", l, w.score[l], s.score, w.round[l], s.round);
+            mismatches++;
+        }
+    }
+
+    double laneSecs = std::chrono::duration<double>(mid - start).count();
+    double gameSecs = std::chrono::duration<double>(end - mid).count();
+    double total = (double)ticks * LANES;
+    printf("lanes: %d x %lld ticks\n", LANES, ticks);
+    printf("lane kernel: %.3f s (%.0f ticks/s)\n", laneSecs, laneSecs > 0 ? total / laneSecs : 0.0);
+    printf("step(): %.3f s (%.0f ticks/s)\n", gameSecs, gameSecs > 0 ? total / gameSecs : 0.0);
+    printf("match: %s\n", mismatches ? "NO" : "yes");
+    return mismatches ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    long long ticks = 1000000;
+    unsigned long long seed = 1;
+    const char* recordPath = nullptr;
+    int rows = ALIEN_ROWS, cols = ALIEN_COLS;
+    bool sized = false;
+    bool bulletHell = false;
+    float speedUp = game().roundSpeedUp;
+    bool checkAllocs = false;
+    int historySeconds = 0;
+    bool lanes = false;
+    int fireEvery = 0;
+    const char* profileOut = nullptr;
+    const char* replayPath = nullptr;
+    int stepTicks = 1;
+    int sweepTicks = 0;
+    static waveFile waves;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc) replayPath = argv[++i];
+        else if (!strcmp(argv[i], "--waves") && i + 1 < argc) {
+            if (!waves.open(argv[++i])) {
+                printf("could not load waves %s: %s\n", argv[i], waves.error);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--rows") && i + 1 < argc) {
+            rows = atoi(argv[++i]);
+            sized = true;
+        }
+        else if (!strcmp(argv[i], "--cols") && i + 1 < argc) {
+            cols = atoi(argv[++i]);
+            sized = true;
+        }
+        else if (!strcmp(argv[i], "--bullet-hell")) bulletHell = true;
+        else if (!strcmp(argv[i], "--speedup") && i + 1 < argc) speedUp = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--check-allocs")) checkAllocs = true;
+        else if (!strcmp(argv[i], "--history") && i + 1 < argc) historySeconds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--lanes")) lanes = true;
+        else if (!strcmp(argv[i], "--fire-every") && i + 1 < argc) fireEvery = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--step-ticks") && i + 1 < argc) stepTicks = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--sweep-check") && i + 1 < argc) sweepTicks = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--profile-out") && i + 1 < argc) profileOut = argv[++i];
+        else {
+            printf("usage: %s [--ticks N] [--seed S] [--rows R] [--cols C] [--speedup F] [--bullet-hell] [--check-allocs]\n"
+                "       [--waves FILE]    play the rounds of a compiled wave file\n"
+                "       [--record FILE]   save the scripted run as a replay\n"
+                "       [--history S]     snapshot every tick into a ring of the last S seconds\n"
+                "       [--lanes]         compare the lane kernel against step() (power-ups off, built-in waves)\n"
+                "       [--fire-every N]  with --lanes, shoot every N ticks instead of the script's 12\n"
+                "       [--profile-out NAME]  write NAME.csv / NAME.json (profiling builds)\n"
+                "       [--sweep-check K] play a scripted game at 1 and at K ticks per step and compare how they end\n"
+                "       %s --replay FILE [--waves FILE] [--step-ticks K]  re-simulate a recorded session,\n"
+                "                         fast-forwarding up to K ticks per step while the input holds\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+
+    if (replayPath) return playReplay(replayPath, waves, stepTicks);
+    if (sweepTicks) return sweepCheck(seed, sweepTicks);
+    if ((bulletHell || sized) && waves.waves) {
+        // every round takes its size and fire from the wave file
+        printf("--bullet-hell, --rows and --cols only apply to the built-in progression, not --waves\n");
+        return 1;
+    }
+
+    static game config; // settings every game here starts from
+    waves.use(config);
+    config.waveRows = rows;
+    config.waveCols = cols;
+    config.roundSpeedUp = speedUp;
+    if (bulletHell) {
+        // every tick a volley, keeps a couple of thousand shots in the air
+        config.alienFireOdds = 1;
+        config.alienVolley = 16;
+    }
+    if (lanes) {
+        for (int k = 0; k < POWERUP_KINDS; k++) config.dropOdds[k] = 0;
+        return runWorlds(ticks, seed, config, fireEvery);
+    }
+
+    game g = config;
+    seedGame(g, seed);
+    resetGame(g);
+
+    replay rec;
+    if (recordPath) {
+        rec.begin(g);
+        rec.inputs.reserve((size_t)ticks);
+    }
+
+    // same always-on capture the game uses for rewind, to measure what it costs
+    history timeline(historySeconds * TICK_RATE);
+
+    int games = 1;
+    long long peakBullets = 0;
+    int bestScore = 0, bestRound = 1;
+
+    // the first second of play warms up any lazily sized scratch space
+    const long long warmup = TICK_RATE;
+    long long allocsAtWarmup = 0;
+
+#if SI_PROFILE
+    profileThisThread("sim");
+#endif
+    auto start = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; t++) {
+        PROFILE_FRAME();
+        if (t == warmup) allocsAtWarmup = allocationCount();
+        input in = scriptedInput(g, t);
+        if (in.restart) {
+            if (g.score > bestScore) bestScore = g.score;
+            if (g.round > bestRound) bestRound = g.round;
+            games++;
+        }
+        if (recordPath) rec.record(in);
+        step(g, in);
+        if (historySeconds > 0) timeline.capture(g);
+        long long live = g.playerBullets.size() + g.homingBullets.size() + g.alienBullets.size();
+        if (live > peakBullets) peakBullets = live;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (g.score > bestScore) bestScore = g.score;
+    if (g.round > bestRound) bestRound = g.round;
+
+    double secs = std::chrono::duration<double>(end - start).count();
+    printf("ticks: %lld\n", ticks);
+    printf("games: %d\n", games);
+    printf("best score: %d (round %d)\n", bestScore, bestRound);
+    printf("peak bullets: %lld\n", peakBullets);
+    printf("time: %.3f s (%.0f ticks/s)\n", secs, secs > 0 ? ticks / secs : 0.0);
+
+#if SI_PROFILE
+    // per-tick phase times over the last ticks of the run
+    profileStats stats[MAX_PROFILE_PHASES];
+    int phases = profileSummary(stats, MAX_PROFILE_PHASES);
+    for (int i = 0; i < phases; i++)
+        printf("%-16s min %.2f avg %.2f p99 %.2f us\n", stats[i].name,
+            stats[i].minMs * 1000, stats[i].avgMs * 1000, stats[i].p99Ms * 1000);
+    if (profileOut) {
+        std::string base = profileOut;
+        profileDump((base + ".csv").c_str(), (base + ".json").c_str());
+    }
+#else
+    (void)profileOut;
+#endif
+
+    if (historySeconds > 0)
+        printf("snapshots: %d kept of %lld (%zu bytes each)\n", timeline.size(), ticks, sizeof(game));
+
+    if (recordPath && !rec.save(recordPath)) {
+        printf("could not write replay %s\n", recordPath);
+        return 1;
+    }
+
+    if (checkAllocs && ticks > warmup) {
+        long long allocs = allocationCount() - allocsAtWarmup;
+        printf("allocations after warm-up: %lld\n", allocs);
+        if (allocs != 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+#include "lanes.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "broadphase.h"
+#include "simd.h"
+
+worlds::worlds() {
+    for (int l = 0; l < LANES; l++) {
+        seedWorld(*this, l, 0);
+        paused[l] = false;
+        resetWorld(*this, l);
+    }
+}
+
+// ticks the slowest alien shot (a spread one) takes to fall the height of the screen
+static const int ALIEN_SHOT_TICKS = (int)(HEIGHT / (ALIEN_BULLET_SPEED * 0.8f)) + 1;
+
+const char* checkWorlds(const game& config) {
+    if (config.waves) return "lanes only play the built-in progression";
+    for (int k = 0; k < POWERUP_KINDS; k++)
+        if (config.dropOdds[k] != 0) return "lanes play with power-ups off (every drop odds 0)";
+    if ((long long)config.alienVolley * ALIEN_SHOT_TICKS > LANE_ALIEN_BULLETS)
+        return "the alien volley can put more shots in the air than a lane holds";
+    return nullptr;
+}
+
+void setupWorlds(worlds& w, const game& config) {
+    w.waveRows = config.waveRows;
+    w.waveCols = config.waveCols;
+    w.alienFireOdds = config.alienFireOdds;
+    w.alienVolley = config.alienVolley;
+    w.roundSpeedUp = config.roundSpeedUp;
+}
+
+void seedWorld(worlds& w, int lane, uint64_t seed) {
+    w.seed[lane] = seed;
+    w.random[lane].seed(seed, STREAM_GAMEPLAY);
+}
+
+void resetWorld(worlds& w, int l) {
+    w.playerX[l] = WIDTH / 2;
+    w.aliensRight[l] = -1;
+    w.playerBullets[l].clear();
+    w.alienBullets[l].clear();
+    w.alienSpeed[l] = BUILTIN_ALIEN_SPEED;
+    w.score[l] = 0;
+    w.gameOver[l] = false;
+    w.ended[l] = END_NONE;
+    w.aliens[l].reset(w.waveRows, w.waveCols);
+    builtinLayout(w.aliens[l], w.alienX[l], w.alienY[l]);
+    w.round[l] = 1;
+    w.alienFirePattern[l] = builtinFirePattern(1);
+    w.totalShots[l] = 0;
+    w.hits[l] = 0;
+}
+
+// player movement and clamping for the lanes in `live`
+static void movePlayers(worlds& w, const int* live, const int* left, const int* right) {
+    int l = 0;
+#ifdef SI_SSE2
+    const __m128 speed = _mm_set1_ps(game::playerSpeed);
+    const __m128 lo = _mm_set1_ps(PLAYER_HALF_WIDTH), hi = _mm_set1_ps((float)WIDTH - PLAYER_HALF_WIDTH);
+    for (; l + 4 <= LANES; l += 4) {
+        __m128 on = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(live + l)));
+        __m128 goLeft = _mm_and_ps(_mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(left + l))), speed);
+        __m128 goRight = _mm_and_ps(_mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(right + l))), speed);
+        __m128 x = _mm_loadu_ps(w.playerX + l);
+        __m128 moved = _mm_max_ps(lo, _mm_min_ps(hi, _mm_add_ps(_mm_sub_ps(x, goLeft), goRight)));
+        _mm_storeu_ps(w.playerX + l, _mm_or_ps(_mm_and_ps(on, moved), _mm_andnot_ps(on, x)));
+    }
+#endif
+    for (; l < LANES; l++) {
+        if (!live[l]) continue;
+        if (left[l]) w.playerX[l] -= game::playerSpeed;
+        if (right[l]) w.playerX[l] += game::playerSpeed;
+        w.playerX[l] = std::max(PLAYER_HALF_WIDTH, std::min((float)WIDTH - PLAYER_HALF_WIDTH, w.playerX[l]));
+    }
+}
+
+// formation movement and edge bounce for the lanes in `live`; leftX / rightX
+// are each lane's outermost alive columns relative to alienX
+static void moveFormations(worlds& w, const int* live, const float* leftX, const float* rightX) {
+    int l = 0;
+#ifdef SI_SSE2
+    const __m128 reach = _mm_set1_ps(ALIEN_HALF_SIZE);
+    const __m128 minX = _mm_set1_ps(FORMATION_MARGIN), maxX = _mm_set1_ps((float)WIDTH - FORMATION_MARGIN);
+    const __m128 drop = _mm_set1_ps(FORMATION_DROP);
+    for (; l + 4 <= LANES; l += 4) {
+        __m128 on = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(live + l)));
+        __m128 right = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(w.aliensRight + l)));
+        __m128 x = _mm_loadu_ps(w.alienX + l);
+        __m128 y = _mm_loadu_ps(w.alienY + l);
+        __m128 speed = _mm_loadu_ps(w.alienSpeed + l);
+
+        // edges before the move, same as step()
+        __m128 leftEdge = _mm_sub_ps(_mm_add_ps(x, _mm_loadu_ps(leftX + l)), reach);
+        __m128 rightEdge = _mm_add_ps(_mm_add_ps(x, _mm_loadu_ps(rightX + l)), reach);
+        __m128 flip = _mm_or_ps(_mm_and_ps(right, _mm_cmpgt_ps(rightEdge, maxX)),
+            _mm_andnot_ps(right, _mm_cmplt_ps(leftEdge, minX)));
+        flip = _mm_and_ps(flip, on);
+
+        __m128 movedX = _mm_or_ps(_mm_and_ps(right, _mm_add_ps(x, speed)), _mm_andnot_ps(right, _mm_sub_ps(x, speed)));
+        _mm_storeu_ps(w.alienX + l, _mm_or_ps(_mm_and_ps(on, movedX), _mm_andnot_ps(on, x)));
+        _mm_storeu_ps(w.alienY + l, _mm_sub_ps(y, _mm_and_ps(flip, drop)));
+        _mm_storeu_si128((__m128i*)(w.aliensRight + l), _mm_castps_si128(_mm_xor_ps(right, flip)));
+    }
+#endif
+    for (; l < LANES; l++) {
+        if (!live[l]) continue;
+        float leftEdge = w.alienX[l] + leftX[l] - ALIEN_HALF_SIZE;
+        float rightEdge = w.alienX[l] + rightX[l] + ALIEN_HALF_SIZE;
+        if (w.aliensRight[l]) {
+            w.alienX[l] += w.alienSpeed[l];
+            if (rightEdge > WIDTH - FORMATION_MARGIN) {
+                w.aliensRight[l] = 0;
+                w.alienY[l] -= FORMATION_DROP;
+            }
+        }
+        else {
+            w.alienX[l] -= w.alienSpeed[l];
+            if (leftEdge < FORMATION_MARGIN) {
+                w.aliensRight[l] = -1;
+                w.alienY[l] -= FORMATION_DROP;
+            }
+        }
+    }
+}
+
+// bullets, alien fire and collisions for one live lane; playerMoved and
+// alienMovedX/Y are how far the player and the formation moved this tick,
+// for the swept tests
+static void stepLane(worlds& w, int l, float playerMoved, float alienMovedX, float alienMovedY) {
+    formation& f = w.aliens[l];
+    auto& pb = w.playerBullets[l];
+    auto& ab = w.alienBullets[l];
+
+    pb.advance(1.0f);
+    ab.advance(-1.0f);
+
+    // alien shooting (random alive alien), as alienFire() does without power-ups
+    rng& random = w.random[l];
+    if (random.below(w.alienFireOdds) == 0) {
+        for (int v = 0; v < w.alienVolley && !f.empty(); v++) {
+            int ay, ax;
+            f.nth(random.below(f.alive), ay, ax);
+            float dx, dy;
+            fireDirection(random, w.alienFirePattern[l], dx, dy);
+            ab.push(w.alienX[l] + ax * f.pitchX, w.alienY[l] - ay * f.pitchY, ALIEN_BULLET_SPEED, dx, dy);
+        }
+    }
+
+    // player bullets vs aliens: most shots are nowhere near the formation, so
+    // only those inside its bounding box (plus the hit reach, how far a shot
+    // moves relative to the formation in a tick and a pixel of slack) go
+    // through the exact lattice test, in their original order
+    int n = pb.size();
+    if (n > 0 && !f.empty()) {
+        float slackX = fabs(alienMovedX) + 1, slackY = SHOT_SPEED + fabs(alienMovedY) + 1;
+        float reachX = ALIEN_HALF_SIZE + SHOT_HALF_WIDTH + slackX, reachY = ALIEN_HALF_SIZE + SHOT_HALF_HEIGHT + slackY;
+        float boxX1 = w.alienX[l] + f.leftColumn() * f.pitchX - reachX;
+        float boxX2 = w.alienX[l] + f.rightColumn() * f.pitchX + reachX;
+        float boxY1 = w.alienY[l] - f.bottomRow() * f.pitchY - reachY;
+        float boxY2 = w.alienY[l] - lowestBit(f.rowMask) * f.pitchY + reachY;
+
+        int near[LANE_PLAYER_BULLETS], m = 0;
+        int i = 0;
+#ifdef SI_SSE2
+        const __m128 x1 = _mm_set1_ps(boxX1), x2 = _mm_set1_ps(boxX2);
+        const __m128 y1 = _mm_set1_ps(boxY1), y2 = _mm_set1_ps(boxY2);
+        for (; i + 4 <= n; i += 4) {
+            __m128 bx = _mm_loadu_ps(pb.x + i), by = _mm_loadu_ps(pb.y + i);
+            int in = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(bx, x1), _mm_cmplt_ps(bx, x2)),
+                _mm_and_ps(_mm_cmpgt_ps(by, y1), _mm_cmplt_ps(by, y2))));
+            for (; in; in &= in - 1) near[m++] = i + lowestBit(in);
+        }
+#endif
+        for (; i < n; i++)
+            if (pb.x[i] > boxX1 && pb.x[i] < boxX2 && pb.y[i] > boxY1 && pb.y[i] < boxY2) near[m++] = i;
+
+        if (m > 0) {
+            float cx[LANE_PLAYER_BULLETS], cy[LANE_PLAYER_BULLETS];
+            float mx[LANE_PLAYER_BULLETS], my[LANE_PLAYER_BULLETS];
+            unsigned char hit[LANE_PLAYER_BULLETS];
+            for (int k = 0; k < m; k++) {
+                cx[k] = pb.x[near[k]];
+                cy[k] = pb.y[near[k]];
+                mx[k] = pb.moveX(near[k], 1.0f) - alienMovedX;
+                my[k] = pb.moveY(near[k], 1.0f, 1.0f) - alienMovedY;
+                hit[k] = 1;
+            }
+            int kills = hitFormation(f, w.alienX[l], w.alienY[l], m, cx, cy, mx, my, hit, [](float, float) {});
+            if (kills > 0) {
+                unsigned char keep[LANE_PLAYER_BULLETS];
+                std::fill(keep, keep + n, 1);
+                for (int k = 0; k < m; k++) keep[near[k]] = hit[k];
+                w.score[l] += 100 * kills;
+                w.hits[l] += kills;
+                pb.compact(keep);
+            }
+        }
+    }
+
+    // alien bullets vs player (there is never a shield here): the ones that
+    // ended up inside the box, then those whose path this tick crossed it
+    float px1 = w.playerX[l] - PLAYER_HALF_WIDTH, px2 = w.playerX[l] + PLAYER_HALF_WIDTH;
+    float py1 = PLAYER_BOTTOM, py2 = PLAYER_TOP;
+    bool shot = false;
+    int i = 0;
+#ifdef SI_SSE2
+    const __m128 x1 = _mm_set1_ps(px1), x2 = _mm_set1_ps(px2);
+    const __m128 y1 = _mm_set1_ps(py1), y2 = _mm_set1_ps(py2);
+    __m128 any = _mm_setzero_ps();
+    for (; i + 4 <= ab.size(); i += 4) {
+        __m128 bx = _mm_loadu_ps(ab.x + i), by = _mm_loadu_ps(ab.y + i);
+        any = _mm_or_ps(any, _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(bx, x1), _mm_cmplt_ps(bx, x2)),
+            _mm_and_ps(_mm_cmpgt_ps(by, y1), _mm_cmplt_ps(by, y2))));
+    }
+    shot = _mm_movemask_ps(any) != 0;
+#endif
+    for (; i < ab.size() && !shot; i++)
+        shot = ab.x[i] > px1 && ab.x[i] < px2 && ab.y[i] > py1 && ab.y[i] < py2;
+    for (i = 0; i < ab.size() && !shot; i++) {
+        float t;
+        shot = ab.y[i] < py2 && sweptEntry(ab.x[i], ab.y[i], ab.moveX(i, 1.0f) - playerMoved, ab.moveY(i, -1.0f, 1.0f),
+            px1, py1, px2, py2, t);
+    }
+    if (shot) {
+        w.gameOver[l] = true;
+        w.ended[l] = END_SHOT;
+    }
+
+    // aliens reach the player area
+    if (!f.empty()) {
+        float ay = w.alienY[l] - f.bottomRow() * f.pitchY;
+        if (ay - ALIEN_HALF_SIZE < INVASION_LINE && !w.gameOver[l]) {
+            w.gameOver[l] = true;
+            w.ended[l] = END_INVADED;
+        }
+    }
+
+    pb.cull(-FLT_MAX, HEIGHT);
+    ab.cull(0, FLT_MAX);
+}
+
+void stepWorlds(worlds& w, const input* in) {
+    int live[LANES], left[LANES], right[LANES];
+    float leftX[LANES], rightX[LANES];
+
+    // input and end-of-game checks
+    for (int l = 0; l < LANES; l++) {
+        if (in[l].pause) w.paused[l] = !w.paused[l];
+        if (in[l].restart && w.gameOver[l]) resetWorld(w, l);
+        left[l] = in[l].left ? -1 : 0;
+        right[l] = in[l].right ? -1 : 0;
+        if (in[l].fire && !w.gameOver[l]) {
+            w.totalShots[l]++;
+            w.playerBullets[l].push(w.playerX[l], MUZZLE_Y, SHOT_SPEED);
+        }
+        if (w.round[l] > BUILTIN_ROUNDS) {
+            w.round[l]--;
+            w.gameOver[l] = true;
+            w.ended[l] = END_CLEARED;
+        }
+        live[l] = w.paused[l] || w.gameOver[l] ? 0 : -1;
+    }
+
+    float playerX[LANES];
+    std::copy(w.playerX, w.playerX + LANES, playerX);
+    movePlayers(w, live, left, right);
+
+    // round system: a cleared formation starts the next round
+    for (int l = 0; l < LANES; l++) {
+        formation& f = w.aliens[l];
+        if (live[l] && f.empty()) {
+            w.round[l]++;
+            f.reset(w.waveRows, w.waveCols);
+            builtinLayout(f, w.alienX[l], w.alienY[l]);
+            w.aliensRight[l] = -1;
+            w.alienSpeed[l] *= w.roundSpeedUp;
+            w.alienFirePattern[l] = builtinFirePattern(w.round[l]);
+            w.playerBullets[l].clear();
+            w.alienBullets[l].clear();
+        }
+        leftX[l] = f.empty() ? 0.0f : f.leftColumn() * f.pitchX;
+        rightX[l] = f.empty() ? 0.0f : f.rightColumn() * f.pitchX;
+    }
+
+    float alienX[LANES], alienY[LANES];
+    std::copy(w.alienX, w.alienX + LANES, alienX);
+    std::copy(w.alienY, w.alienY + LANES, alienY);
+    moveFormations(w, live, leftX, rightX);
+
+    for (int l = 0; l < LANES; l++)
+        if (live[l]) stepLane(w, l, w.playerX[l] - playerX[l], w.alienX[l] - alienX[l], w.alienY[l] - alienY[l]);
+}
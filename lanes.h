@@ -0,0 +1,57 @@
+#pragma once
+#include "sim.h"
+
+// "many worlds": LANES independent games stepped together for bulk training
+// runs. Per-game scalars are stored lane-major (slot l of every array belongs
+// to game l) so player movement, formation movement and the edge bounce run
+// for all lanes in one SIMD pass, as do the pre-filters in front of the
+// collision tests. Alien fire and the exact collision tests run lane by lane
+// on each lane's own bitboard formation and bullet streams, with the same
+// kernels and rule constants (sim.h) as step().
+//
+// Lanes play the built-in progression with power-ups off: a lane reproduces a
+// game set up the same way exactly. Its player bullet pool is as big as
+// step()'s, so no rate of fire drops a shot only one of them would keep;
+// checkWorlds() rejects anything a lane can't reproduce.
+const int LANES = 8;
+const int LANE_PLAYER_BULLETS = MAX_PLAYER_BULLETS;
+const int LANE_ALIEN_BULLETS = 256;
+
+struct worlds {
+    // setup shared by every lane, same meaning as the game fields (see setupWorlds)
+    int waveRows = ALIEN_ROWS, waveCols = ALIEN_COLS;
+    int alienFireOdds = 25, alienVolley = 1;
+    float roundSpeedUp = 1.25f;
+
+    // per lane
+    uint64_t seed[LANES];
+    rng random[LANES];
+    float playerX[LANES];
+    float alienX[LANES], alienY[LANES], alienSpeed[LANES];
+    int aliensRight[LANES]; // -1 moving right, 0 moving left (used as a SIMD mask)
+    int alienFirePattern[LANES];
+    formation aliens[LANES];
+    bulletStream<LANE_PLAYER_BULLETS> playerBullets[LANES];
+    bulletStream<LANE_ALIEN_BULLETS> alienBullets[LANES];
+    int totalShots[LANES], hits[LANES];
+    int round[LANES], score[LANES];
+    bool paused[LANES], gameOver[LANES];
+    endReason ended[LANES];
+
+    // every lane seeded with 0 and ready to play
+    worlds();
+};
+
+// why games set up like config can't run in lanes (a wave table, power-ups,
+// more alien fire than a lane's pool holds), or nullptr when they can
+const char* checkWorlds(const game& config);
+
+// take config's settings for every lane; reset the lanes afterwards
+void setupWorlds(worlds& w, const game& config);
+
+// same as seedGame / resetGame for one lane
+void seedWorld(worlds& w, int lane, uint64_t seed);
+void resetWorld(worlds& w, int lane);
+
+// one tick of every lane, in[l] is lane l's input
+void stepWorlds(worlds& w, const input* in);
@@ -0,0 +1,40 @@
+#include "latency.h"
+#include <algorithm>
+
+double latencyMeter::swapped(unsigned shownKeys, clock_type::time_point at) {
+    frames++;
+    double ms = -1;
+    // anything further behind than the ring has been overwritten
+    if (shownKeys - shown > RING) shown = shownKeys - RING;
+    for (; shown != shownKeys; shown++) {
+        const stamp& s = stamps[shown % RING];
+        if (!s.press) continue;
+        ms = std::max(ms, std::chrono::duration<double, std::milli>(at - s.at).count());
+    }
+    if (ms >= 0) {
+        samples.push_back({ frames, shownKeys, ms });
+        last = ms;
+    }
+    return ms;
+}
+
+void latencyMeter::printSummary(FILE* out) const {
+    if (samples.empty()) {
+        fprintf(out, "input latency: no key presses\n");
+        return;
+    }
+    std::vector<double> ms;
+    ms.reserve(samples.size());
+    for (const sample& s : samples) ms.push_back(s.ms);
+    std::sort(ms.begin(), ms.end());
+    fprintf(out, "input latency (key down to swap) over %zu frames: min %.2f, median %.2f, p99 %.2f, max %.2f ms\n",
+        ms.size(), ms[0], ms[ms.size() / 2], ms[ms.size() * 99 / 100], ms.back());
+}
+
+bool latencyMeter::writeCsv(const char* path) const {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "frame,keys,latency_ms\n");
+    for (const sample& s : samples) fprintf(f, "%lld,%u,%.3f\n", s.frame, s.keys, s.ms);
+    return fclose(f) == 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// input-to-swap latency: every key event handed to the sim is stamped with the
+// time it arrived, and each frame reports how long the oldest key press it is
+// the first to show has been waiting. Events are identified by their position
+// in the key queue (keysSent when sent, keysApplied once the sim used them),
+// so a tick the render thread never draws doesn't lose its presses.
+struct latencyMeter {
+    typedef std::chrono::steady_clock clock_type;
+    static const unsigned RING = 4096; // key events that can be in flight
+
+    // a key event (number seq of the ones sent) arrived at time at
+    void sent(unsigned seq, bool press, clock_type::time_point at) {
+        stamps[seq % RING] = { at, press };
+    }
+
+    // a frame showing the first shownKeys events was swapped at time at;
+    // records and returns the frame's latency in ms, or -1 when it shows no new press
+    double swapped(unsigned shownKeys, clock_type::time_point at);
+
+    // min / median / p99 / max over every frame so far, and the per-frame
+    // numbers as CSV (frame, keys shown, latency ms)
+    void printSummary(FILE* out) const;
+    bool writeCsv(const char* path) const;
+
+    double last = -1; // latency of the latest frame that showed a press
+
+private:
+    struct stamp {
+        clock_type::time_point at;
+        bool press = false;
+    };
+    stamp stamps[RING];
+    unsigned shown = 0; // events already shown by an earlier frame
+    long long frames = 0;
+
+    struct sample {
+        long long frame;
+        unsigned keys;
+        double ms;
+    };
+    std::vector<sample> samples;
+};
@@ -1,425 +1,193 @@
 #include <GL/glut.h>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
-#include <vector>
+#include <cstring>
+#include <condition_variable>
 #include <ctime>
-
-// game constants
-const int WIDTH = 1000;
-const int HEIGHT = 600;
-const int ALIEN_ROWS = 4;
-const int ALIEN_COLS = 8;
-
-// game state
-struct game {
-
-    // player
-    float playerX = WIDTH / 2;
-    const float playerSpeed = 5.0f;
-    bool leftPressed = false;
-    bool rightPressed = false;
-
-    // aliens
-    float alienX = 50;
-    float alienY = 400;
-    float alienSpeed = 0.5f;
-    bool aliensRight = true;
-
-    // aliens alive state
-    bool aliens[ALIEN_ROWS][ALIEN_COLS];
-
-    // bullets
-    struct bullet {
-        float x, y, speed;
-        float dx = 0, dy = 0; // direction for homing
-        bool homing = false;
-    };
-
-    std::vector<bullet> playerBullets;
-    std::vector<bullet> alienBullets;
-    
-    // accuracy
-    int totalShots = 0;
-    int hits = 0;
-
-    // game state
-    int round = 1;
-    int score = 0;
-    bool paused = false;
-    bool gameOver = false;
-
-    bool slowAlienBulletsActive = false;
-    int slowAlienBulletsTimer = 0; // frames or ms
-
-    bool homingBulletsActive = false;
-    int homingBulletsTimer = 0; // frames or ms
-
-    bool shieldActive = false;
-    int shieldTimer = 0; // frames or ms
-
-
-    // power-ups
-    struct powerup { float x, y; int type; int timer; };
-    std::vector<powerup> powerups;
-
-} game;
-
-// utility function: drawing a string using GLUT bitmap font
-void drawString(void* font, const char* string, float x, float y) {
-    glRasterPos2f(x, y);
-    for (const char* c = string; *c != '\0'; c++) {
-        glutBitmapCharacter(font, *c);
-    }
-}
+#include <mutex>
+#include <thread>
+#include "glrender.h"
+#include "handoff.h"
+#include "latency.h"
+#include "profiler.h"
+#include "replay.h"
+#include "scene.h"
+#include "sim.h"
+#include "snapshot.h"
+#include "waves.h"
+
+// the simulation runs on its own thread at a steady TICK_RATE, whatever the
+// window is doing. Keys reach it through a lock-free queue and every tick is
+// published through a triple buffer; the GLUT thread only ever draws the
+// newest published state, so a slow swap can't hold up gameplay.
+
+// sim thread state: once the sim thread has started, only it touches game,
+// prevGame, keys, rewinding, timeline and recording
+struct game game;
+struct game prevGame; // state before the last tick
+
+// keys held / pressed since the last tick
+input keys;
+
+// fire is rate limited here rather than by the OS key repeat (which is
+// switched off): holding SPACE fires every FIRE_COOLDOWN ticks, and a press
+// during the cooldown is kept and fires as soon as it ends. Rewinding and
+// restarting start the limiter over
+const int FIRE_COOLDOWN = 8; // ticks, 7.5 shots a second
+bool fireHeld = false;
+bool firePressed = false; // pressed since the last shot
+int fireCooldown = 0;     // ticks until the next shot may go
+
+// gameplay seed (--seed, otherwise the clock) and the separate stream used for
+// purely visual randomness, so drawing never shifts the gameplay sequence
+unsigned long long gameSeed = 0;
+rng cosmetic;
+
+// every tick is captured so holding BACKSPACE can rewind the last few seconds
+const int REWIND_SECONDS = 5;
+history timeline(REWIND_SECONDS * TICK_RATE);
+bool rewinding = false;
+
+#if SI_PROFILE
+bool showProfile = false; // per-phase timing overlay, toggled with P
+#endif
+
+// rounds come from this table when started with --waves, otherwise the built-in progression
+waveFile waveTable;
+
+// every tick's input when running with --record
+replay recording;
+const char* recordPath = nullptr;
+
+// fixed-timestep loop: the simulation always ticks at TICK_RATE, rendering
+// runs as fast as it can (or at maxFps) and interpolates between the last two ticks
+typedef std::chrono::steady_clock clock_type;
+const double TICK = 1.0 / TICK_RATE;
+int maxFps = 0;              // 0 = uncapped (or vsync if the driver forces it)
+clock_type::time_point nextFrame;
+
+// what a key does, sent from the GLUT callbacks to the sim thread
+enum keyAction { KEY_LEFT, KEY_RIGHT, KEY_FIRE, KEY_PAUSE, KEY_RESTART, KEY_REWIND };
+struct keyEvent {
+    unsigned char action;
+    bool down;
+};
+spscQueue<keyEvent, 1024> keyEvents;
+unsigned keysSent = 0;    // events queued so far (GLUT thread)
+unsigned keysApplied = 0; // events applied so far (sim thread)
+
+// one published tick: the two states to interpolate between and when the
+// newer one was made
+struct frameState {
+    struct game prev, cur;
+    clock_type::time_point at;
+    bool live = true;     // more ticks follow without new input
+    unsigned keys = 0;    // keysApplied when this was published
+};
+tripleBuffer<frameState> frames;
+
+// what each tick reported (kills, shield blocks, pickups), on its way to the
+// particles; the triple buffer may skip ticks, this queue doesn't
+spscQueue<simEvent, 4096> simEvents;
+
+// the sim thread parks on this while nothing can change; the queue itself
+// never locks, the mutex only guards going to sleep
+std::thread simThread;
+std::atomic<bool> quitting{ false };
+std::mutex simWakeMutex;
+std::condition_variable simWake;
+
+// key down to swap times, kept by the GLUT thread (--latency FILE writes them out)
+latencyMeter latency;
+const char* latencyPath = nullptr;
+
+// window backend, the per-frame scene batch and the HUD text it was last drawn with
+glRenderer gl;
+batch frameBatch;
+hud hudText;
+
+// particles live on the GLUT thread, advanced once per frame by real time
+particleSystem effects;
+clock_type::time_point lastFrame;
 
 void init() {
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluOrtho2D(0, WIDTH, 0, HEIGHT);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    gl.init();
 
     // initialize all aliens to alive
-    for (int y = 0; y < ALIEN_ROWS; y++)
-        for (int x = 0; x < ALIEN_COLS; x++)
-            game.aliens[y][x] = true;
-
-    std::srand((unsigned int)time(0));
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-}
-
-void drawPlayer() {
-    float cx = game.playerX;
-    float baseY = 20.0f;
-    
-    // draw shield if active
-    if (game.shieldActive) {
-        float cx = game.playerX;
-        float baseY = 20.0f;
-        glColor4f(0.3f, 0.7f, 1.0f, 0.28f); // blue, semi-transparent
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 32; ++i) {
-            float theta = 2.0f * 3.14159f * i / 32;
-            glVertex2f(cx + cos(theta) * 28, baseY + 16 + sin(theta) * 28);
-        }
-        glEnd();
-    }
-
-    // main body
-    glColor3f(0.2f, 0.8f, 1.0f);
-    glBegin(GL_POLYGON);
-    glVertex2f(cx - 12, baseY + 16);
-    glVertex2f(cx - 18, baseY + 12);
-    glVertex2f(cx - 12, baseY + 4);
-    glVertex2f(cx + 12, baseY + 4);
-    glVertex2f(cx + 18, baseY + 12);
-    glVertex2f(cx + 12, baseY + 16);
-    glEnd();
-
-    // cockpit
-    glColor3f(0.3f, 0.3f, 1.0f);
-    glBegin(GL_POLYGON);
-    for (int i = 0; i < 32; ++i) {
-        float theta = i / 32.0f * 3.14159f;
-        float x = cx + cos(theta) * 6;
-        float y = baseY + 16 + sin(theta) * 8;
-        glVertex2f(x, y);
-    }
-    glEnd();
-
-    // nose
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(cx, baseY + 34);
-    glVertex2f(cx - 8, baseY + 16);
-    glVertex2f(cx + 8, baseY + 16);
-    glEnd();
-
-    // left wing
-    glColor3f(0.7f, 0.7f, 0.7f);
-    glBegin(GL_POLYGON);
-    glVertex2f(cx - 12, baseY + 12);
-    glVertex2f(cx - 28, baseY + 6);
-    glVertex2f(cx - 24, baseY + 2);
-    glVertex2f(cx - 12, baseY + 4);
-    glEnd();
-
-    // right wing
-    glBegin(GL_POLYGON);
-    glVertex2f(cx + 12, baseY + 12);
-    glVertex2f(cx + 28, baseY + 6);
-    glVertex2f(cx + 24, baseY + 2);
-    glVertex2f(cx + 12, baseY + 4);
-    glEnd();
-
-    // left engine
-    glColor3f(0.8f, 0.4f, 0.1f);
-    glBegin(GL_QUADS);
-    glVertex2f(cx - 22, baseY + 0);
-    glVertex2f(cx - 18, baseY + 0);
-    glVertex2f(cx - 18, baseY + 4);
-    glVertex2f(cx - 22, baseY + 4);
-    glEnd();
-
-    // right engine
-    glBegin(GL_QUADS);
-    glVertex2f(cx + 18, baseY + 0);
-    glVertex2f(cx + 22, baseY + 0);
-    glVertex2f(cx + 22, baseY + 4);
-    glVertex2f(cx + 18, baseY + 4);
-    glEnd();
-
-    // engine flames (flicker effect)
-    glColor3f(1.0f, 0.8f, 0.1f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(cx - 20, baseY + 0);
-    glVertex2f(cx - 19, baseY - 8 - rand() % 4);
-    glVertex2f(cx - 21, baseY - 8 - rand() % 4);
-    glVertex2f(cx + 20, baseY + 0);
-    glVertex2f(cx + 19, baseY - 8 - rand() % 4);
-    glVertex2f(cx + 21, baseY - 8 - rand() % 4);
-    glEnd();
-
-    // highlights on body
-    glColor3f(0.8f, 1.0f, 1.0f);
-    glBegin(GL_LINES);
-    glVertex2f(cx, baseY + 4);
-    glVertex2f(cx, baseY + 16);
-    glEnd();
-    glBegin(GL_LINES);
-    glVertex2f(cx - 6, baseY + 8);
-    glVertex2f(cx - 6, baseY + 14);
-    glVertex2f(cx + 6, baseY + 8);
-    glVertex2f(cx + 6, baseY + 14);
-    glEnd();
-}
-
-void drawEvilAlienShip(float x, float y) {
-    // main hull (dark, spiky, compact)
-    glColor3f(0.35f, 0.05f, 0.15f);
-    glBegin(GL_POLYGON);
-    glVertex2f(x, y + 10);
-    glVertex2f(x - 10, y + 4);
-    glVertex2f(x - 13, y - 4);
-    glVertex2f(x - 6, y - 12);
-    glVertex2f(x, y - 16);
-    glVertex2f(x + 6, y - 12);
-    glVertex2f(x + 13, y - 4);
-    glVertex2f(x + 10, y + 4);
-    glEnd();
-
-    // cockpit
-    glColor3f(0.9f, 0.1f, 0.2f);
-    glBegin(GL_POLYGON);
-    for (int i = 0; i < 14; ++i) {
-        float theta = 2.0f * 3.14159f * i / 14;
-        glVertex2f(x + cos(theta) * 3.5f, y - 1 + sin(theta) * 3.5f);
-    }
-    glEnd();
-
-    // side spikes
-    glColor3f(0.6f, 0.0f, 0.2f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(x - 13, y - 4);
-    glVertex2f(x - 18, y - 8);
-    glVertex2f(x - 6, y - 12);
-
-    glVertex2f(x + 13, y - 4);
-    glVertex2f(x + 18, y - 8);
-    glVertex2f(x + 6, y - 12);
-    glEnd();
-
-    // glowing spoons
-    glColor3f(1.0f, 0.9f, 0.2f);
-    glBegin(GL_POLYGON);
-    for (int i = 0; i < 8; ++i) {
-        float theta = 2.0f * 3.14159f * i / 8;
-        glVertex2f(x - 4.5f + cos(theta) * 1.0f, y - 7 + sin(theta) * 1.0f);
-    }
-    glEnd();
-    glBegin(GL_POLYGON);
-    for (int i = 0; i < 8; ++i) {
-        float theta = 2.0f * 3.14159f * i / 8;
-        glVertex2f(x + 4.5f + cos(theta) * 1.0f, y - 7 + sin(theta) * 1.0f);
-    }
-    glEnd();
-
-    // lower mandibles (dark)
-    glColor3f(0.25f, 0.0f, 0.1f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(x - 3, y - 14);
-    glVertex2f(x - 1, y - 19);
-    glVertex2f(x, y - 16);
-
-    glVertex2f(x + 3, y - 14);
-    glVertex2f(x + 1, y - 19);
-    glVertex2f(x, y - 16);
-    glEnd();
+    seedGame(game, gameSeed);
+    cosmetic.seed(gameSeed, STREAM_COSMETIC);
+    waveTable.use(game);
+    resetGame(game);
+    prevGame = game;
+    if (recordPath) recording.begin(game);
+    timeline.capture(game);
+
+    buildMeshes();
+    frameBatch.verts.reserve((1 << 16) + MAX_PARTICLES * 6); // keep the per-frame batch from growing mid-game
 }
 
-void drawAliens() {
-    for (int y = 0; y < ALIEN_ROWS; y++) {
-        for (int x = 0; x < ALIEN_COLS; x++) {
-            if (!game.aliens[y][x]) continue;
-            float ax = game.alienX + x * 60;
-            float ay = game.alienY - y * 40;
-            drawEvilAlienShip(ax, ay);
-        }
-    }
+// idle mode: while paused or on the game-over screen nothing moves, so the
+// sim thread waits for a key instead of ticking and, once that state is
+// drawn, the GLUT loop unregisters its idle callback and just waits for
+// events (window exposes still redraw through display())
+bool sleeping = false;
+void frame();
+
+// whether the next ticks can differ from the last one: the game is running,
+// being rewound, or has a one-shot key waiting for the next tick (a waiting
+// shot only counts while running, see applyKey)
+bool live() {
+    return rewinding || keys.pause || keys.restart || (!game.paused && !game.gameOver);
 }
 
-void drawBullets() {
-
-    // player bullets (thin laser)
-    /*
-    for (auto& b : game.playerBullets) {
-        // outer glow (optional, for effect)
-        glColor4f(0.2f, 1.0f, 1.0f, 0.18f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 16; ++i) {
-            float theta = 2.0f * 3.14159f * i / 16;
-            glVertex2f(b.x + cos(theta) * 3, b.y + sin(theta) * 12);
-        }
-        glEnd();
-
-        // thin core
-        glColor3f(0.8f, 1.0f, 1.0f);
-        glBegin(GL_QUADS);
-        glVertex2f(b.x - 1, b.y - 10);
-        glVertex2f(b.x + 1, b.y - 10);
-        glVertex2f(b.x + 1, b.y + 14);
-        glVertex2f(b.x - 1, b.y + 14);
-        glEnd();
-    }
-    */
-    for (auto& b : game.playerBullets) {
-        float angle = atan2(b.dy, b.dx);
-
-        glPushMatrix();
-        glTranslatef(b.x, b.y, 0);
-        glRotatef(angle * 180.0f / 3.14159f - 90.0f, 0, 0, 1); // -90 so tip points along (dx,dy)
-
-        // outer glow (optional)
-        glColor4f(0.2f, 1.0f, 1.0f, 0.18f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 16; ++i) {
-            float theta = 2.0f * 3.14159f * i / 16;
-            glVertex2f(cos(theta) * 5, sin(theta) * 16);
-        }
-        glEnd();
-
-        // bullet tip (triangle)
-        glColor3f(0.8f, 1.0f, 1.0f);
-        glBegin(GL_TRIANGLES);
-        glVertex2f(0, 14);    // tip
-        glVertex2f(-3, -8);   // left base
-        glVertex2f(3, -8);    // right base
-        glEnd();
-
-        glPopMatrix();
-    }
-
-    // alien bullets (yellow)
-    for (auto& b : game.alienBullets) {
-        float pulse = 1.0f + 0.3f * sin(b.y * 0.25f);
-        glColor3f(0.6f + 0.3f * pulse, 1.0f - 0.4f * pulse, 0.1f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 18; ++i) {
-            float theta = 2.0f * 3.14159f * i / 18;
-            glVertex2f(b.x + cos(theta) * 7 * pulse, b.y + sin(theta) * 7 * pulse);
-        }
-        glEnd();
-    }
+// input arrived: start drawing again
+void wake() {
+    if (!sleeping) return;
+    sleeping = false;
+    lastFrame = clock_type::now(); // particles don't catch up on the time spent asleep
+    glutIdleFunc(frame);
+    glutPostRedisplay();
 }
 
-void drawPowerups() {
-    for (auto& p : game.powerups) {
-
-        // color based on power-up type
-        float r = 0.3f, g = 1.0f, b = 0.7f; // default: green (slow bullets)
-        if (p.type == 1) { // slow alien bullets
-            r = 0.3f; g = 1.0f; b = 0.7f; // green/cyan
-        }
-        else if (p.type == 2) { // homing bullets
-            r = 1.0f; g = 0.0f; b = 0.2f; // orange/red
-        }
-        else if (p.type == 3) { // shield
-            r = 0.5f; g = 0.7f; b = 1.0f; // blue
-        }
-        
-        // outer glow
-        glColor4f(r, g, b, 0.18f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 24; ++i) {
-            float theta = 2.0f * 3.14159f * i / 24;
-            glVertex2f(p.x + cos(theta) * 14, p.y + sin(theta) * 14);
-        }
-        glEnd();
-
-        // main orb
-        glColor3f(r, g, b);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 20; ++i) {
-            float theta = 2.0f * 3.14159f * i / 20;
-            glVertex2f(p.x + cos(theta) * 8, p.y + sin(theta) * 8);
-        }
-        glEnd();
-        // inner highlight
-        glColor4f(1.0f, 1.0f, 1.0f, 0.28f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 12; ++i) {
-            float theta = 2.0f * 3.14159f * i / 12;
-            glVertex2f(p.x + cos(theta) * 4, p.y + sin(theta) * 4);
-        }
-        glEnd();
-    }
+// hand a key to the sim thread, stamped with when it arrived (a full queue drops it)
+void sendKey(keyAction action, bool down) {
+    if (!keyEvents.push({ (unsigned char)action, down })) return;
+    latency.sent(keysSent, down, clock_type::now());
+    keysSent++;
+    { std::lock_guard<std::mutex> lock(simWakeMutex); }
+    simWake.notify_one();
 }
 
 void keyboard(unsigned char key, int, int) {
-    
+    wake();
+
     if (key == 27) { // ESC key
-        game.paused = !game.paused; // toggle pause on/off
+        sendKey(KEY_PAUSE, true); // toggle pause on/off
         return;
     }
 
-    if (key == 'a' || key == 'A') game.leftPressed = true;
-    if (key == 'd' || key == 'D') game.rightPressed = true;
+    if (key == 'a' || key == 'A') sendKey(KEY_LEFT, true);
+    if (key == 'd' || key == 'D') sendKey(KEY_RIGHT, true);
     
-    if (key == ' ' && !game.gameOver) {
-        game.totalShots++;
-        if (game.homingBulletsActive) {
-            game.playerBullets.push_back({ game.playerX, 50, 8.0f, 0, 1.0f, true });
-        }
-        else {
-            game.playerBullets.push_back({ game.playerX, 50, 8.0f, 0, 1.0f, false });
-        }
-    }
+    if (key == ' ') sendKey(KEY_FIRE, true);
 
     // restart game on enter after game over
-    if (key == 13 && game.gameOver) {
-        // reset game state
-        game.playerX = WIDTH / 2;
-        game.alienX = 50;
-        game.alienY = 400;
-        game.aliensRight = true;
-        game.playerBullets.clear();
-        game.alienBullets.clear();
-        game.alienSpeed = 0.5f;
-        game.score = 0;
-        game.gameOver = false;
-        for (int y = 0; y < ALIEN_ROWS; y++)
-            for (int x = 0; x < ALIEN_COLS; x++)
-                game.aliens[y][x] = true;
-        game.round = 1;
-        game.totalShots = 0;
-        game.hits = 0;
-    }
+    if (key == 13) sendKey(KEY_RESTART, true);
+
+    if (key == 8) sendKey(KEY_REWIND, true); // backspace
+
+#if SI_PROFILE
+    if (key == 'p' || key == 'P') showProfile = !showProfile;
+#endif
 }
 
 void keyboardUp(unsigned char key, int, int) {
-    if (key == 'a' || key == 'A') game.leftPressed = false;
-    if (key == 'd' || key == 'D') game.rightPressed = false;
+    if (key == ' ') sendKey(KEY_FIRE, false);
+    if (key == 8) sendKey(KEY_REWIND, false);
+    if (key == 'a' || key == 'A') sendKey(KEY_LEFT, false);
+    if (key == 'd' || key == 'D') sendKey(KEY_RIGHT, false);
 }
 
 // glutSpecialFunc(specialInput); 
@@ -428,385 +196,255 @@ void keyboardUp(unsigned char key, int, int) {
 //glutSpecialUpFunc(specialUpInput); 
 // tells GLUT to call specialUpInput function when a special key is released
 
-// both of these are used in update() 
+// both of these are queued for the sim thread
 // lets us use the LEFT and RIGHT arrow keys
 
 void specialInput(int key, int, int) {
-    if (key == GLUT_KEY_LEFT)  game.leftPressed = true;
-    if (key == GLUT_KEY_RIGHT) game.rightPressed = true;
+    wake();
+    if (key == GLUT_KEY_LEFT)  sendKey(KEY_LEFT, true);
+    if (key == GLUT_KEY_RIGHT) sendKey(KEY_RIGHT, true);
 }
 
 void specialUpInput(int key, int, int) {
-    if (key == GLUT_KEY_LEFT)  game.leftPressed = false;
-    if (key == GLUT_KEY_RIGHT) game.rightPressed = false;
+    if (key == GLUT_KEY_LEFT)  sendKey(KEY_LEFT, false);
+    if (key == GLUT_KEY_RIGHT) sendKey(KEY_RIGHT, false);
 }
 
-void checkCollisions() {
-    for (auto it = game.playerBullets.begin(); it != game.playerBullets.end(); ) {
-        bool bulletUsed = false;
-
-        // check collision with all aliens
-        for (int y = 0; y < ALIEN_ROWS && !bulletUsed; y++) {
-            for (int x = 0; x < ALIEN_COLS && !bulletUsed; x++) {
-                if (!game.aliens[y][x]) continue;
-
-                // alien bounding box
-                float ax = game.alienX + x * 60;
-                float ay = game.alienY - y * 40;
-                float alienLeft = ax - 15;
-                float alienRight = ax + 15;
-                float alienBottom = ay - 15;
-                float alienTop = ay + 15;
-
-                // bullet bounding box
-                float bulletLeft = it->x - 2;
-                float bulletRight = it->x + 2;
-                float bulletBottom = it->y - 8;
-                float bulletTop = it->y + 8;
-
-                // AABB collision check
-                if (bulletLeft < alienRight &&
-                    bulletRight > alienLeft &&
-                    bulletBottom < alienTop &&
-                    bulletTop > alienBottom) {
-
-                    // destroy alien and bullet
-                    game.aliens[y][x] = false;
-
-                    // power-ups logic
-                    if (rand() % 10 == 0) {
-                        game.powerups.push_back({ ax, ay, 1, 0 }); // type 1 = slow bullets
-                    }
-
-                    if (rand() % 10 == 0) {
-                        game.powerups.push_back({ ax, ay, 2, 0 }); // type 2 = homing bullets
-                    }
-
-                    if (rand() % 20 == 0) {
-                        game.powerups.push_back({ ax, ay, 3, 0 }); // type 3 = shield
-                    }
-
-                    game.score += 100;
-                    game.hits++;
-                    it = game.playerBullets.erase(it);
-                    bulletUsed = true;
-                }
-            }
-        }
+// write the --record file when the window closes
+void saveRecording() {
+    if (!recording.save(recordPath))
+        fprintf(stderr, "could not write replay %s\n", recordPath);
+}
 
-        if (!bulletUsed) ++it; // only increment if bullet wasn't used
+// run one simulation tick with the keys gathered since the last one
+void tick() {
+    PROFILE_SCOPE("tick");
+    int round = game.round;
+    bool over = game.gameOver;
+
+    saveState(game, prevGame);
+    if (rewinding) {
+        // play the timeline backwards, and drop the undone ticks from the recording too
+        int back = timeline.rewind(game, 1);
+        if (recordPath) recording.inputs.resize(recording.inputs.size() - back);
+
+        // the limiter isn't in the snapshots: play on from the rewound state unlimited
+        firePressed = false;
+        fireCooldown = 0;
+    } else {
+        if (fireCooldown > 0) fireCooldown--;
+        keys.fire = (firePressed || fireHeld) && fireCooldown == 0;
+        if (keys.fire) {
+            firePressed = false;
+            fireCooldown = FIRE_COOLDOWN;
+        }
+        if (recordPath) recording.record(keys);
+        step(game, keys);
+        timeline.capture(game);
+        for (const simEvent& e : game.events) simEvents.push(e); // a full queue drops the effect
     }
 
-    // alien bullets vs player
-    float px1 = game.playerX - 20, px2 = game.playerX + 20;
-    float py1 = 20, py2 = 50;
-    for (auto it = game.alienBullets.begin(); it != game.alienBullets.end(); ) {
-        if (it->x > px1 && it->x < px2 && it->y > py1 && it->y < py2) {
-            if (game.shieldActive) {
-                // shield active
-                it = game.alienBullets.erase(it);
-                continue;
-            }
-            else {
-                // no shield active
-                game.gameOver = true;
-                break;
-            }
-        }
+    // a press waits for the cooldown only while the game runs, and a new game
+    // starts with no cooldown left over from the last one
+    if (game.paused || game.gameOver) firePressed = false;
+    if (over && !game.gameOver) fireCooldown = 0;
 
-        ++it;
-    }
+    // don't slide between unrelated states after a new round or restart
+    if (game.round != round || game.gameOver != over) saveState(game, prevGame);
 
-    // power-up collection
-    for (auto it = game.powerups.begin(); it != game.powerups.end(); ) {
-        // check if player collects the powerup (e.g., overlap with player)
-        if (fabs(it->x - game.playerX) < 20 && it->y < 60) { // adjust bounds as needed
-            if (it->type == 1) { // 1 = slow alien bullets
-                game.slowAlienBulletsActive = true;
-                game.slowAlienBulletsTimer = 200; // 3s at 60 FPS
-            }
-            if (it->type == 2) { // 2 = homing bullets
-                game.homingBulletsActive = true;
-                game.homingBulletsTimer = 200; // 3s at 60 FPS
-            }
-            if (it->type == 3) { // 3 = shield
-                game.shieldActive = true;
-                game.shieldTimer = 600; // 10s 60 FPS
-            }
-
-            it = game.powerups.erase(it); // remove collected powerup
-        }
-        else {
-            ++it;
-        }
-    }
+    // one-shot keys only apply to a single tick
+    keys.pause = false;
+    keys.restart = false;
 }
 
-void update(int)     {
-    
-    if (game.round > 15) {
-        game.round--;
-        game.gameOver = true;
-    }
-
-    if (game.paused) {
-        glutTimerFunc(16, update, 0); // timer running for input
-        return;
+// held keys follow their key's state, one-shot keys stay set until a tick uses them
+void applyKey(const keyEvent& e) {
+    switch (e.action) {
+    case KEY_LEFT: keys.left = e.down; break;
+    case KEY_RIGHT: keys.right = e.down; break;
+    case KEY_FIRE:
+        firePressed = firePressed || (e.down && !game.paused && !game.gameOver);
+        fireHeld = e.down;
+        break;
+    case KEY_PAUSE: keys.pause = keys.pause || e.down; break;
+    case KEY_RESTART: keys.restart = keys.restart || e.down; break;
+    case KEY_REWIND: rewinding = e.down; break;
     }
+    keysApplied++;
+}
 
-    if (!game.gameOver) {
-        // power-up
-        if (game.slowAlienBulletsActive) {
-            game.slowAlienBulletsTimer--;
-            if (game.slowAlienBulletsTimer <= 0)
-                game.slowAlienBulletsActive = false;
-        }
-
-        if (game.homingBulletsActive) {
-            game.homingBulletsTimer--;
-            if (game.homingBulletsTimer <= 0)
-                game.homingBulletsActive = false;
-        }
+// hand the latest tick to the render thread
+void publish(bool ticking) {
+    frameState& s = frames.back();
+    saveState(ticking ? prevGame : game, s.prev); // a parked sim shows a still frame
+    saveState(game, s.cur);
+    s.at = clock_type::now();
+    s.live = ticking;
+    s.keys = keysApplied;
+    frames.publish();
+}
 
-        if (game.shieldActive) {
-            game.shieldTimer--;
-            if (game.shieldTimer <= 0)
-                game.shieldActive = false;
+void simLoop() {
+#if SI_PROFILE
+    profileThisThread("sim");
+#endif
+    const auto tickTime = std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(TICK));
+    clock_type::time_point next = clock_type::now();
+    while (!quitting) {
+        keyEvent e;
+        while (keyEvents.pop(e)) applyKey(e);
+
+        if (!live()) {
+            publish(false);
+            std::unique_lock<std::mutex> lock(simWakeMutex);
+            simWake.wait(lock, [] { return quitting || !keyEvents.empty(); });
+            next = clock_type::now(); // don't catch up on the time spent parked
+            continue;
         }
 
-        for (auto& p : game.powerups) {
-            p.y -= 2.0f; // adjust speed as desired
-        }
-        game.powerups.erase(
-            std::remove_if(game.powerups.begin(), game.powerups.end(),
-                [](const game::powerup& p) { return p.y < 0; }),
-            game.powerups.end()
-        );
-
-        // player movement
-        if (game.leftPressed) game.playerX -= game.playerSpeed;
-        if (game.rightPressed) game.playerX += game.playerSpeed;
-        game.playerX = std::max(20.0f, std::min((float)WIDTH - 20, game.playerX));
-
-        // round system check
-        bool allDead = true;
-        for (int y = 0; y < ALIEN_ROWS; y++) {
-            for (int x = 0; x < ALIEN_COLS; x++) {
-                if (game.aliens[y][x]) {
-                    allDead = false;
-                    break;
-                }
-            }
-            if (!allDead) break;
-        }
+        tick();
+        publish(true);
 
-        if (allDead) {
-            game.round++;
-            
-            // reset aliens
-            for (int y = 0; y < ALIEN_ROWS; y++)
-                for (int x = 0; x < ALIEN_COLS; x++)
-                    game.aliens[y][x] = true;
-            
-            // reset alien position
-            game.alienX = 50;
-            game.alienY = 400;
-            game.aliensRight = true;
-            game.alienSpeed *= 1.25f;
-            
-            // clear bullets
-            game.playerBullets.clear();
-            game.alienBullets.clear();
-        }
+        next += tickTime;
+        clock_type::time_point now = clock_type::now();
+        if (now - next > std::chrono::milliseconds(250)) next = now; // don't spiral after a long stall
+        std::this_thread::sleep_until(next);
+    }
+}
 
-        // alien movement
-        int aliveLeft = ALIEN_COLS, aliveRight = -1;
-        for (int y = 0; y < ALIEN_ROWS; y++)
-            for (int x = 0; x < ALIEN_COLS; x++)
-                if (game.aliens[y][x]) {
-                    aliveLeft = std::min(aliveLeft, x);
-                    aliveRight = std::max(aliveRight, x);
-                }
-        float leftEdge = game.alienX + aliveLeft * 60 - 15;
-        float rightEdge = game.alienX + aliveRight * 60 + 15;
-        if (game.aliensRight) {
-            game.alienX += game.alienSpeed;
-            if (rightEdge > WIDTH - 10) {
-                game.aliensRight = false;
-                game.alienY -= 20;
-            }
-        }
-        else {
-            game.alienX -= game.alienSpeed;
-            if (leftEdge < 10) {
-                game.aliensRight = true;
-                game.alienY -= 20;
-            }
-        }
+// stop the sim thread before the exit handlers save what it owns
+void stopSim() {
+    {
+        std::lock_guard<std::mutex> lock(simWakeMutex);
+        quitting = true;
+    }
+    simWake.notify_one();
+    if (simThread.joinable()) simThread.join();
+}
 
-        // update playerBullets
-        for (auto& b : game.playerBullets) {
-            if (b.homing) {
-                // find nearest alive alien
-                float bestDist = 1e9, tx = 0, ty = 0;
-                bool found = false;
-                for (int y = 0; y < ALIEN_ROWS; y++) {
-                    for (int x = 0; x < ALIEN_COLS; x++) {
-                        if (!game.aliens[y][x]) continue;
-                        float ax = game.alienX + x * 60;
-                        float ay = game.alienY - y * 40;
-                        float dx = ax - b.x, dy = ay - b.y;
-                        float dist = dx * dx + dy * dy;
-                        if (dist < bestDist) {
-                            bestDist = dist;
-                            tx = ax;
-                            ty = ay;
-                            found = true;
-                        }
-                    }
-                }
-                if (found) {
-                    float vx = tx - b.x, vy = ty - b.y;
-                    float len = sqrt(vx * vx + vy * vy);
-                    if (len > 1e-2) {
-                        vx /= len; vy /= len;
-                        b.dx = b.dx * 0.85f + vx * 0.15f;
-                        b.dy = b.dy * 0.85f + vy * 0.15f;
-                        float dlen = sqrt(b.dx * b.dx + b.dy * b.dy);
-                        b.dx /= dlen; b.dy /= dlen;
-                    }
-                }
-                b.x += b.dx * b.speed;
-                b.y += b.dy * b.speed;
-            }
-            else {
-                b.y += b.speed;
-            }
-        }
+void frame() {
+    PROFILE_FRAME(); // closes the previous frame: its draw and the sim ticks that ran meanwhile
 
-        // update alienBullets
-        for (auto& b : game.alienBullets) {
-            if (game.round > 5 && (b.dx != 0.0f || b.dy != 0.0f)) {
-                b.x += b.dx * b.speed;
-                b.y -= b.dy * b.speed;
-            }
-            else {
-                b.y -= b.speed;
-            }
-        }
+    if (maxFps > 0) {
+        std::this_thread::sleep_until(nextFrame);
+        nextFrame = std::max(nextFrame + std::chrono::microseconds(1000000 / maxFps), clock_type::now());
+    }
 
+    frames.update();
+    const frameState& s = frames.front();
+
+    // particles: spawn what the sim reported, then advance by frame time
+    // (frozen while paused, and a long stall doesn't fast-forward them)
+    clock_type::time_point now = clock_type::now();
+    float dt = std::min(0.1f, std::chrono::duration<float>(now - lastFrame).count());
+    lastFrame = now;
+    simEvent e;
+    while (simEvents.pop(e)) effects.spawnEvents(cosmetic, &e, 1);
+    if (!s.cur.paused) {
+        if (!s.cur.gameOver) effects.trail(cosmetic, s.cur.playerX, dt);
+        effects.update(dt);
+    }
 
-        // remove off-screen bullets
-        game.playerBullets.erase(
-            std::remove_if(game.playerBullets.begin(), game.playerBullets.end(),
-                [](const game::bullet& b) { return b.y > HEIGHT; }),
-            game.playerBullets.end()
-        );
-        game.alienBullets.erase(
-            std::remove_if(game.alienBullets.begin(), game.alienBullets.end(),
-                [](const game::bullet& b) { return b.y < 0; }),
-            game.alienBullets.end()
-        );
-
-        // alien shooting (random alive alien)
-        if (rand() % 25 == 0) { // adjust for more/less frequent shooting
-            std::vector<std::pair<int, int>> aliveAliens;
-            for (int y = 0; y < ALIEN_ROWS; y++)
-                for (int x = 0; x < ALIEN_COLS; x++)
-                    if (game.aliens[y][x])
-                        aliveAliens.push_back({ y, x });
-            if (!aliveAliens.empty()) {
-                float alienBulletSpeed = game.slowAlienBulletsActive ? 1.5f : 4.0f;
-                int idx = rand() % aliveAliens.size();
-                int ay = aliveAliens[idx].first;
-                int ax = aliveAliens[idx].second;
-
-                // axfter round 5, allow diagonal bullets
-                float dx = 0.0f;
-                float dy = 1.0f;
-                if (game.round > 5) {
-                    int dir = rand() % 3; // 0: left-diagonal, 1: straight, 2: right-diagonal
-                    if (dir == 0) dx = -0.7f;
-                    else if (dir == 2) dx = 0.7f;
-                    // dy stays 1.0f
-                    float norm = sqrt(dx * dx + dy * dy);
-                    dx /= norm; dy /= norm; // normalize so speed stays consistent
-                }
-                game.alienBullets.push_back({
-                    game.alienX + ax * 60,
-                    game.alienY - ay * 40,
-                    alienBulletSpeed,
-                    dx, dy
-                    });
-            }
+    glutPostRedisplay();
 
-        }
+    // draw this frame, then sleep until input; keys the sim hasn't seen yet
+    // may still change the state, so keep polling until it has, and let the
+    // last particles finish unless the game is paused
+    if (!s.live && s.keys == keysSent && (s.cur.paused || effects.size() == 0)) {
+        sleeping = true;
+        glutIdleFunc(nullptr);
+    }
+}
 
-        // check collisions
-        checkCollisions();
-
-        // game over condition: aliens reach player area
-        for (int y = 0; y < ALIEN_ROWS; y++)
-            for (int x = 0; x < ALIEN_COLS; x++)
-                if (game.aliens[y][x]) {
-                    float ay = game.alienY - y * 40;
-                    if (ay - 15 < 60) // approaching player
-                        game.gameOver = true;
-                }
+#if SI_PROFILE
+// per-phase frame times under the HUD
+void drawProfile() {
+    if (!showProfile) return;
+    profileStats stats[MAX_PROFILE_PHASES];
+    int n = profileSummary(stats, MAX_PROFILE_PHASES);
+
+    float y = HEIGHT - 60;
+    gl.text(TEXT_UNCACHED, "PHASE            MIN     AVG     P99 (ms)", 10, y, 12, 0.6f, 1.0f, 0.6f);
+    for (int i = 0; i < n; i++) {
+        char line[96];
+        snprintf(line, sizeof(line), "%-16s %6.3f  %6.3f  %6.3f", stats[i].name, stats[i].minMs, stats[i].avgMs, stats[i].p99Ms);
+        y -= 14;
+        gl.text(TEXT_UNCACHED, line, 10, y, 12, 0.6f, 1.0f, 0.6f);
+    }
+    if (latency.last >= 0) {
+        char line[96];
+        snprintf(line, sizeof(line), "%-16s %6.3f", "input to swap", latency.last);
+        y -= 14;
+        gl.text(TEXT_UNCACHED, line, 10, y, 12, 0.6f, 1.0f, 0.6f);
     }
+}
 
-    glutPostRedisplay();
-    glutTimerFunc(16, update, 0); // ~60 FPS
+void dumpProfile() {
+    if (profileDump("profile.csv", "profile.json"))
+        printf("profile written to profile.csv and profile.json\n");
 }
+#endif
 
 void display() {
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    drawPlayer();
-    drawAliens();
-    drawBullets();
-    drawPowerups();
-
-    //  game score
-    glColor3f(1.0f, 1.0f, 1.0f);
-    char scoreStr[64];
-    sprintf_s(scoreStr, "SCORE: %d", game.score);
-    drawString(GLUT_BITMAP_HELVETICA_18, scoreStr, 10, HEIGHT - 30);
-    
-    char roundStr[32];
-    sprintf_s(roundStr, "ROUND: %d", game.round);
-    drawString(GLUT_BITMAP_HELVETICA_18, roundStr, WIDTH / 2 - 50, HEIGHT - 30);
-
-    // shot accuracy
-    float accuracy = game.totalShots > 0 ?
-        (static_cast<float>(game.hits) / game.totalShots) * 100.0f : 0.0f;
-    char accStr[32];
-    sprintf_s(accStr, "ACCURACY: %.1f%%", accuracy);
-    drawString(GLUT_BITMAP_HELVETICA_18, accStr,WIDTH - 190, HEIGHT - 30);
-
-    // game over
-    if (game.gameOver) {
-        drawString(GLUT_BITMAP_HELVETICA_18, "GAME OVER", WIDTH / 2 - 60, HEIGHT / 2);
-        drawString(GLUT_BITMAP_HELVETICA_12, "PRESS ENTER TO RESTART", WIDTH / 2 - 70, HEIGHT / 2 - 30);
+    PROFILE_SCOPE("frame");
+    const frameState& s = frames.front();
+    float alpha = std::min(1.0f, std::chrono::duration<float>(clock_type::now() - s.at).count() / (float)TICK);
+    renderFrame(gl, frameBatch, hudText, s.prev, s.cur, alpha, cosmetic, &effects);
+#if SI_PROFILE
+    drawProfile();
+#endif
+
+    {
+        PROFILE_SCOPE("draw: swap");
+        glutSwapBuffers();
     }
+    latency.swapped(s.keys, clock_type::now());
+}
 
-    glutSwapBuffers();
+// print the latency numbers and write the per-frame ones when the window closes
+void saveLatency() {
+    latency.printSummary(stdout);
+    if (!latency.writeCsv(latencyPath))
+        fprintf(stderr, "could not write %s\n", latencyPath);
 }
 
 int main(int argc, char** argv) {
 
     glutInit(&argc, argv);
+    gameSeed = (unsigned long long)time(0);
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--fps") && i + 1 < argc) maxFps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) gameSeed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!strcmp(argv[i], "--latency") && i + 1 < argc) latencyPath = argv[++i];
+        else if (!strcmp(argv[i], "--waves") && i + 1 < argc && !waveTable.open(argv[++i])) {
+            fprintf(stderr, "could not load waves %s: %s\n", argv[i], waveTable.error);
+            return 1;
+        }
+    }
+
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
     glutInitWindowSize(WIDTH, HEIGHT);
     glutCreateWindow("SPACE INVADERS");
 
     init();
+    glutIgnoreKeyRepeat(1); // held keys are tracked by their up events, fire has its own rate
+    if (recordPath) atexit(saveRecording);
+    if (latencyPath) atexit(saveLatency);
+#if SI_PROFILE
+    profileThisThread("render");
+    atexit(dumpProfile);
+#endif
+    publish(true);
+    simThread = std::thread(simLoop);
+    atexit(stopSim); // registered last, so it runs before the handlers above
+    nextFrame = lastFrame = clock_type::now();
     glutDisplayFunc(display);
     glutKeyboardFunc(keyboard);
     glutKeyboardUpFunc(keyboardUp);
     glutSpecialFunc(specialInput);
     glutSpecialUpFunc(specialUpInput);
-    glutTimerFunc(0, update, 0);
+    glutIdleFunc(frame);
     glutMainLoop();
     return 0;
 }
\ No newline at end of file
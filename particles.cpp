@@ -0,0 +1,151 @@
+#include "particles.h"
+#include <algorithm>
+#include <cmath>
+#include "simd.h"
+
+static const float GRAVITY = -140.0f; // px/s^2, debris arcs down
+static const float DRAG = 1.5f;       // fraction of speed lost per second
+static const float TRAIL_RATE = 90.0f; // particles per second per engine
+static const float TWO_PI = 6.2831853f;
+
+particleSystem::particleSystem()
+    : x(MAX_PARTICLES), y(MAX_PARTICLES), vx(MAX_PARTICLES), vy(MAX_PARTICLES),
+      life(MAX_PARTICLES), fade(MAX_PARTICLES),
+      r(MAX_PARTICLES), g(MAX_PARTICLES), b(MAX_PARTICLES), radius(MAX_PARTICLES) {}
+
+void particleSystem::spawn(float x_, float y_, float vx_, float vy_, float life_, float r_, float g_, float b_, float radius_) {
+    if (count == MAX_PARTICLES || life_ <= 0.0f) return;
+    int i = count++;
+    x[i] = x_;
+    y[i] = y_;
+    vx[i] = vx_;
+    vy[i] = vy_;
+    life[i] = life_;
+    fade[i] = 1.0f / life_;
+    r[i] = r_;
+    g[i] = g_;
+    b[i] = b_;
+    radius[i] = radius_;
+}
+
+void particleSystem::burst(rng& random, int n, float x_, float y_, float minSpeed, float maxSpeed,
+    float minLife, float maxLife, float r_, float g_, float b_, float radius_) {
+    for (int k = 0; k < n; k++) {
+        float angle = random.unit() * TWO_PI;
+        float speed = minSpeed + (maxSpeed - minSpeed) * random.unit();
+        float l = minLife + (maxLife - minLife) * random.unit();
+        spawn(x_, y_, cosf(angle) * speed, sinf(angle) * speed, l, r_, g_, b_, radius_);
+    }
+}
+
+void particleSystem::spawnEvents(rng& random, const simEvent* events, int n) {
+    for (int i = 0; i < n; i++) {
+        const simEvent& e = events[i];
+        switch (e.kind) {
+        case EVENT_KILL:
+            // hull debris in the alien's colors, then a quick white flash of sparks
+            burst(random, 10, e.x, e.y, 40, 180, 0.5f, 1.0f, 0.9f, 0.1f, 0.2f, 2.5f);
+            burst(random, 6, e.x, e.y, 40, 140, 0.4f, 0.8f, 0.35f, 0.05f, 0.15f, 2.5f);
+            burst(random, 4, e.x, e.y, 30, 120, 0.3f, 0.6f, 1.0f, 0.9f, 0.2f, 1.5f);
+            burst(random, 8, e.x, e.y, 120, 260, 0.15f, 0.3f, 0.8f, 1.0f, 1.0f, 1.0f);
+            break;
+        case EVENT_SHIELD_BLOCK:
+            burst(random, 10, e.x, e.y, 80, 200, 0.2f, 0.4f, 0.5f, 0.8f, 1.0f, 1.0f);
+            break;
+        case EVENT_POWERUP: {
+            const powerupInfo& c = powerupKinds[e.type];
+            burst(random, 24, e.x, e.y, 60, 110, 0.4f, 0.6f, c.r, c.g, c.b, 2.0f);
+            break;
+        }
+        }
+    }
+}
+
+void particleSystem::trail(rng& random, float playerX, float dt) {
+    trailDebt += TRAIL_RATE * dt;
+    int n = (int)trailDebt;
+    trailDebt -= n;
+    for (int k = 0; k < n; k++) {
+        for (int side = -1; side <= 1; side += 2) {
+            float vx_ = (random.unit() - 0.5f) * 20.0f;
+            float vy_ = -60.0f - 40.0f * random.unit();
+            spawn(playerX + side * 20.0f, 12.0f, vx_, vy_, 0.15f + 0.15f * random.unit(),
+                1.0f, 0.6f + 0.2f * random.unit(), 0.1f, 1.5f);
+        }
+    }
+}
+
+void particleSystem::update(float dt) {
+    if (count == 0 || dt <= 0.0f) return;
+    float keep = std::max(0.0f, 1.0f - DRAG * dt);
+
+    // integrate; the arrays' capacity is a multiple of 4, so the last group
+    // can run past count without a scalar tail
+    int i = 0;
+#ifdef SI_SSE2
+    const __m128 vdt = _mm_set1_ps(dt), vkeep = _mm_set1_ps(keep), vfall = _mm_set1_ps(GRAVITY * dt);
+    for (; i < count; i += 4) {
+        __m128 nvx = _mm_mul_ps(_mm_loadu_ps(&vx[i]), vkeep);
+        __m128 nvy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&vy[i]), vkeep), vfall);
+        _mm_storeu_ps(&vx[i], nvx);
+        _mm_storeu_ps(&vy[i], nvy);
+        _mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(nvx, vdt)));
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(nvy, vdt)));
+        _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), vdt));
+    }
+#else
+    for (; i < count; i++) {
+        vx[i] *= keep;
+        vy[i] = vy[i] * keep + GRAVITY * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+#endif
+
+    // cull: skip groups of four that are all alive, fill holes from the end
+    // (draw order doesn't matter for particles)
+    i = 0;
+#ifdef SI_SSE2
+    const __m128 zero = _mm_setzero_ps();
+#endif
+    while (i < count) {
+#ifdef SI_SSE2
+        if (i + 4 <= count && !_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(&life[i]), zero))) {
+            i += 4;
+            continue;
+        }
+#endif
+        if (life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --count;
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        life[i] = life[last];
+        fade[i] = fade[last];
+        r[i] = r[last];
+        g[i] = g[last];
+        b[i] = b[last];
+        radius[i] = radius[last];
+    }
+}
+
+void particleSystem::draw(batch& out) const {
+    out.verts.reserve(out.verts.size() + (size_t)count * 6);
+    for (int i = 0; i < count; i++) {
+        float s = radius[i];
+        float x0 = x[i] - s, x1 = x[i] + s, y0 = y[i] - s, y1 = y[i] + s;
+        float a = std::min(1.0f, life[i] * fade[i]);
+        vertex v0 = { x0, y0, r[i], g[i], b[i], a }, v2 = { x1, y1, r[i], g[i], b[i], a };
+        out.verts.push_back(v0);
+        out.verts.push_back({ x1, y0, r[i], g[i], b[i], a });
+        out.verts.push_back(v2);
+        out.verts.push_back(v0);
+        out.verts.push_back(v2);
+        out.verts.push_back({ x0, y1, r[i], g[i], b[i], a });
+    }
+}
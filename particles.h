@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include "geometry.h"
+#include "rng.h"
+#include "sim.h"
+
+// most particles alive at once; spawns beyond this are dropped
+const int MAX_PARTICLES = 1 << 17;
+
+// cosmetic particles: explosion debris, impact sparks and engine trails.
+// Storage is fixed-capacity SoA allocated once, integration and lifetime
+// culling run over the plain float arrays (four at a time with SSE2), and
+// every live particle is appended to the frame's batch as a quad, so they
+// all go out in the same single draw call. Nothing here feeds back into the
+// simulation; spawning draws from the caller's cosmetic rng.
+struct particleSystem {
+    particleSystem();
+
+    int size() const { return count; }
+    void clear() { count = 0; }
+
+    // one particle at (x, y) moving at (vx, vy) px/s, fading out over life seconds
+    void spawn(float x, float y, float vx, float vy, float life, float r, float g, float b, float radius);
+
+    // n particles flying out of (x, y) in random directions
+    void burst(rng& random, int n, float x, float y, float minSpeed, float maxSpeed,
+        float minLife, float maxLife, float r, float g, float b, float radius);
+
+    // debris, sparks and flashes for what a tick reported
+    void spawnEvents(rng& random, const simEvent* events, int n);
+
+    // exhaust under the player's engines for dt seconds of play
+    void trail(rng& random, float playerX, float dt);
+
+    // advance dt seconds: move, apply gravity and drag, drop expired particles
+    void update(float dt);
+
+    // one quad per particle into out, alpha following the remaining life
+    void draw(batch& out) const;
+
+private:
+    int count = 0;
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> life, fade; // seconds left, 1 / total life
+    std::vector<float> r, g, b, radius; // color, half the quad size
+    float trailDebt = 0; // fraction of a trail particle carried to the next call
+};
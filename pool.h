@@ -0,0 +1,40 @@
+#pragma once
+
+// fixed-capacity vector living inline in its owner. Nothing is allocated after
+// construction; push_back() reports false instead of growing when it is full.
+template <typename T, int N>
+struct fixedVector {
+    static const int CAPACITY = N;
+
+    T items[N] = {};
+    int count = 0;
+
+    bool push_back(const T& v) {
+        if (count == N) return false;
+        items[count++] = v;
+        return true;
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    void clear() { count = 0; }
+
+    T& operator[](int i) { return items[i]; }
+    const T& operator[](int i) const { return items[i]; }
+    T* data() { return items; }
+    const T* data() const { return items; }
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+    // drop every element matching pred, keeping the rest in order
+    template <typename F>
+    void removeIf(F pred) {
+        int k = 0;
+        for (int i = 0; i < count; i++)
+            if (!pred(items[i])) items[k++] = items[i];
+        count = k;
+    }
+};
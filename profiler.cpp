@@ -0,0 +1,201 @@
+#include "profiler.h"
+
+#if SI_PROFILE
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct event {
+    int phase;
+    long long start, end;
+};
+
+// what one recording thread collected. Only its owner writes it, so its lock
+// is only ever contended when a frame closes or the trace is dumped, never
+// between the threads being measured
+struct threadBuffer {
+    std::mutex lock;
+    int tid = 0;
+    const char* name = nullptr;
+    double current[MAX_PROFILE_PHASES] = {}; // ms spent in each phase this frame
+    std::vector<event> events;               // ring of PROFILE_EVENTS
+    long long eventCount = 0;
+};
+
+// the phase names, the recording threads and the finished frames, behind one
+// lock that recording itself never takes
+struct profilerState {
+    std::mutex lock;
+    const char* names[MAX_PROFILE_PHASES] = {};
+    int phases = 0;
+    std::vector<threadBuffer*> threads; // kept after their thread exits, for the dump
+
+    // rolling window of finished frames
+    float window[PROFILE_WINDOW][MAX_PROFILE_PHASES] = {};
+    int windowFrames = 0;
+
+    // longer history for the CSV, allocated on first use
+    std::vector<float> frames; // PROFILE_FRAMES x MAX_PROFILE_PHASES
+    long long frameCount = 0;
+};
+
+profilerState& state() {
+    static profilerState s;
+    return s;
+}
+
+thread_local threadBuffer* recording = nullptr;
+
+}
+
+long long profileNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profileThisThread(const char* name) {
+    if (recording) return;
+    threadBuffer* b = new threadBuffer;
+    b->events.resize(PROFILE_EVENTS);
+    b->name = name;
+    profilerState& s = state();
+    std::lock_guard<std::mutex> hold(s.lock);
+    b->tid = (int)s.threads.size() + 1;
+    s.threads.push_back(b);
+    recording = b;
+}
+
+int profilePhase(const char* name) {
+    profilerState& s = state();
+    std::lock_guard<std::mutex> hold(s.lock);
+    for (int i = 0; i < s.phases; i++)
+        if (!strcmp(s.names[i], name)) return i;
+    if (s.phases == MAX_PROFILE_PHASES) return -1;
+    s.names[s.phases] = name;
+    return s.phases++;
+}
+
+void profileRecord(int phase, long long start, long long end) {
+    threadBuffer* b = recording;
+    if (!b || phase < 0) return;
+    std::lock_guard<std::mutex> hold(b->lock);
+    b->current[phase] += (end - start) * 1e-6;
+    b->events[b->eventCount % PROFILE_EVENTS] = { phase, start, end };
+    b->eventCount++;
+}
+
+// a frame's phase times are summed over every recording thread
+void profileFrameEnd() {
+    if (!recording) return;
+    profilerState& s = state();
+    std::lock_guard<std::mutex> hold(s.lock);
+    if (s.frames.empty()) s.frames.resize((size_t)PROFILE_FRAMES * MAX_PROFILE_PHASES);
+
+    double sum[MAX_PROFILE_PHASES] = {};
+    for (threadBuffer* b : s.threads) {
+        std::lock_guard<std::mutex> holdThread(b->lock);
+        for (int p = 0; p < MAX_PROFILE_PHASES; p++) {
+            sum[p] += b->current[p];
+            b->current[p] = 0;
+        }
+    }
+    float* row = s.window[s.windowFrames % PROFILE_WINDOW];
+    float* kept = &s.frames[(size_t)(s.frameCount % PROFILE_FRAMES) * MAX_PROFILE_PHASES];
+    for (int p = 0; p < MAX_PROFILE_PHASES; p++) row[p] = kept[p] = (float)sum[p];
+    s.windowFrames++;
+    s.frameCount++;
+}
+
+int profileSummary(profileStats* out, int max) {
+    profilerState& s = state();
+    std::lock_guard<std::mutex> hold(s.lock);
+    int n = std::min(s.windowFrames, PROFILE_WINDOW);
+    int count = std::min(s.phases, max);
+    float sorted[PROFILE_WINDOW];
+    for (int p = 0; p < count; p++) {
+        profileStats& st = out[p];
+        st.name = s.names[p];
+        st.minMs = st.avgMs = st.p99Ms = 0;
+        if (n == 0) continue;
+        double sum = 0;
+        for (int f = 0; f < n; f++) {
+            sorted[f] = s.window[f][p];
+            sum += sorted[f];
+        }
+        int k = std::min(n - 1, (n * 99) / 100);
+        std::nth_element(sorted, sorted + k, sorted + n);
+        st.p99Ms = sorted[k];
+        st.minMs = *std::min_element(sorted, sorted + n);
+        st.avgMs = (float)(sum / n);
+    }
+    return count;
+}
+
+bool profileDump(const char* csvPath, const char* tracePath) {
+    profilerState& s = state();
+    std::lock_guard<std::mutex> hold(s.lock);
+    bool ok = true;
+
+    if (csvPath) {
+        FILE* f = fopen(csvPath, "w");
+        if (f) {
+            fprintf(f, "frame");
+            for (int p = 0; p < s.phases; p++) fprintf(f, ",%s", s.names[p]);
+            fprintf(f, "\n");
+            long long first = std::max(0LL, s.frameCount - PROFILE_FRAMES);
+            for (long long fr = first; fr < s.frameCount; fr++) {
+                const float* row = &s.frames[(size_t)(fr % PROFILE_FRAMES) * MAX_PROFILE_PHASES];
+                fprintf(f, "%lld", fr);
+                for (int p = 0; p < s.phases; p++) fprintf(f, ",%.4f", row[p]);
+                fprintf(f, "\n");
+            }
+            fclose(f);
+        }
+        else ok = false;
+    }
+
+    if (tracePath) {
+        FILE* f = fopen(tracePath, "w");
+        if (f) {
+            // every thread's kept scopes, merged into one timeline
+            struct tracedEvent {
+                event e;
+                int tid;
+            };
+            std::vector<tracedEvent> all;
+            for (threadBuffer* b : s.threads) {
+                std::lock_guard<std::mutex> holdThread(b->lock);
+                for (long long i = std::max(0LL, b->eventCount - PROFILE_EVENTS); i < b->eventCount; i++)
+                    all.push_back({ b->events[i % PROFILE_EVENTS], b->tid });
+            }
+            std::sort(all.begin(), all.end(), [](const tracedEvent& a, const tracedEvent& b) { return a.e.start < b.e.start; });
+
+            // chrome://tracing / Perfetto "complete" events, microseconds, a track per thread
+            fprintf(f, "{\"traceEvents\":[\n");
+            bool first = true;
+            for (threadBuffer* b : s.threads) {
+                if (!b->name) continue;
+                fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}\n",
+                    first ? "" : ",", b->tid, b->name);
+                first = false;
+            }
+            long long origin = all.empty() ? 0 : all[0].e.start;
+            for (const tracedEvent& t : all) {
+                fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}\n",
+                    first ? "" : ",", s.names[t.e.phase], t.tid, (t.e.start - origin) * 1e-3, (t.e.end - t.e.start) * 1e-3);
+                first = false;
+            }
+            fprintf(f, "]}\n");
+            fclose(f);
+        }
+        else ok = false;
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+// frame profiler: PROFILE_SCOPE("name") times the rest of the enclosing block,
+// PROFILE_FRAME() closes a frame. Per frame, each phase's time is summed and
+// kept in a rolling window for min/avg/p99, and the raw scopes go to a ring
+// buffer that can be written out as CSV and a chrome://tracing file.
+//
+// On by default in debug builds and compiled out entirely in release builds;
+// build with SI_PROFILE=1 to profile an optimized build on target hardware.
+// Only threads that called profileThisThread() record anything; each records
+// into its own buffers, and frames and the trace merge them.
+#ifndef SI_PROFILE
+#ifdef NDEBUG
+#define SI_PROFILE 0
+#else
+#define SI_PROFILE 1
+#endif
+#endif
+
+#if SI_PROFILE
+
+const int MAX_PROFILE_PHASES = 32;
+const int PROFILE_WINDOW = 240;       // frames in the rolling stats (~4s at 60 fps)
+const int PROFILE_FRAMES = 36000;     // frames kept for the CSV
+const int PROFILE_EVENTS = 1 << 18;   // scopes kept for the trace, per thread
+
+long long profileNow(); // nanoseconds
+int profilePhase(const char* name);   // id for a phase name, registering it on first use
+void profileRecord(int phase, long long start, long long end);
+void profileFrameEnd();
+void profileThisThread(const char* name = nullptr); // name labels the thread's trace track
+
+struct profileScope {
+    int phase;
+    long long start;
+    explicit profileScope(int p) : phase(p), start(profileNow()) {}
+    ~profileScope() { profileRecord(phase, start, profileNow()); }
+};
+
+// rolling per-frame stats of one phase, in milliseconds
+struct profileStats {
+    const char* name;
+    float minMs, avgMs, p99Ms;
+};
+
+// stats for every phase seen so far; returns how many were written
+int profileSummary(profileStats* out, int max);
+
+// per-frame phase times as CSV and the recent scopes as trace events
+bool profileDump(const char* csvPath, const char* tracePath);
+
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CAT(profileId_, __LINE__) = profilePhase(name); \
+    profileScope PROFILE_CAT(profileScope_, __LINE__)(PROFILE_CAT(profileId_, __LINE__))
+#define PROFILE_FRAME() profileFrameEnd()
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+
+#endif
@@ -0,0 +1,157 @@
+// offscreen renderer: plays a game (bot or replay) and draws every tick with
+// the CPU rasterizer, timing the frames and optionally writing them out
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bot.h"
+#include "replay.h"
+#include "scene.h"
+#include "sim.h"
+#include "swrender.h"
+#include "waves.h"
+
+// FNV-1a over the pixels, printed for the last frame so runs can be compared
+static uint64_t frameHash(const softRenderer& sw) {
+    uint64_t h = 14695981039346656037ull;
+    for (uint8_t p : sw.pixels) {
+        h ^= p;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+int main(int argc, char** argv) {
+    long long ticks = 3600;
+    unsigned long long seed = 1;
+    const char* replayPath = nullptr;
+    const char* out = "frame";
+    int width = WIDTH, height = HEIGHT;
+    long long every = 0; // write every n-th frame, 0 = none
+    bool png = false;
+    const char* expect = nullptr; // last frame hash to check against
+    static waveFile waves;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc) replayPath = argv[++i];
+        else if (!strcmp(argv[i], "--size") && i + 2 < argc) {
+            width = atoi(argv[++i]);
+            height = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--every") && i + 1 < argc) every = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) out = argv[++i];
+        else if (!strcmp(argv[i], "--png")) png = true;
+        else if (!strcmp(argv[i], "--expect") && i + 1 < argc) expect = argv[++i];
+        else if (!strcmp(argv[i], "--waves") && i + 1 < argc) {
+            if (!waves.open(argv[++i])) {
+                printf("could not load waves %s: %s\n", argv[i], waves.error);
+                return 1;
+            }
+        }
+        else {
+            printf("usage: %s [--ticks N] [--seed S] [--replay FILE] [--size W H] [--every N] [--out PREFIX] [--png] [--waves FILE]\n"
+                "       [--expect HASH]  fail unless the last frame hashes to HASH\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width < 1 || height < 1) {
+        printf("bad frame size %dx%d\n", width, height);
+        return 1;
+    }
+
+    game g;
+    waves.use(g);
+    replay r;
+    if (replayPath) {
+        if (!r.load(replayPath)) {
+            printf("could not read replay %s\n", replayPath);
+            return 1;
+        }
+        if (const char* why = r.checkWaves(g)) {
+            printf("can't play replay %s: %s\n", replayPath, why);
+            return 1;
+        }
+        r.start(g);
+        seed = r.seed;
+        ticks = std::min(ticks, (long long)r.inputs.size());
+    } else {
+        seedGame(g, seed);
+        resetGame(g);
+    }
+
+    rng cosmetic;
+    cosmetic.seed(seed, STREAM_COSMETIC);
+    buildMeshes();
+    softRenderer sw(width, height);
+    batch scene;
+    scene.verts.reserve(1 << 16);
+    hud h;
+    particleSystem effects;
+
+    typedef std::chrono::steady_clock clock_type;
+    std::vector<double> frameMs;
+    frameMs.reserve((size_t)ticks);
+    double sceneSecs = 0, rasterSecs = 0;
+    long long triangles = 0, written = 0;
+
+    game prev;
+    for (long long t = 0; t < ticks; t++) {
+        prev = g;
+        step(g, replayPath ? unpackInput(r.inputs[(size_t)t]) : botInput(g, t));
+        effects.spawnEvents(cosmetic, g.events.data(), g.events.size());
+        if (!g.gameOver && !g.paused) effects.trail(cosmetic, g.playerX, 1.0f / TICK_RATE);
+        effects.update(1.0f / TICK_RATE);
+
+        // same order as renderFrame(), split to time the two halves
+        auto t0 = clock_type::now();
+        drawScene(scene, prev, g, 1.0f, cosmetic);
+        effects.draw(scene);
+        auto t1 = clock_type::now();
+        sw.clear();
+        sw.triangles(scene.verts.data(), (int)scene.verts.size());
+        h.draw(sw, g);
+        auto t2 = clock_type::now();
+
+        sceneSecs += std::chrono::duration<double>(t1 - t0).count();
+        rasterSecs += std::chrono::duration<double>(t2 - t1).count();
+        frameMs.push_back(std::chrono::duration<double, std::milli>(t2 - t0).count());
+        triangles += (long long)scene.verts.size() / 3;
+
+        if (every > 0 && t % every == 0) {
+            std::string path = out + std::to_string(t) + (png ? ".png" : ".ppm");
+            if (!(png ? sw.savePNG(path.c_str()) : sw.savePPM(path.c_str()))) {
+                printf("could not write %s\n", path.c_str());
+                return 1;
+            }
+            written++;
+        }
+    }
+
+    if (ticks <= 0) {
+        printf("no frames\n");
+        return 0;
+    }
+    std::vector<double> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    double frames = (double)ticks;
+    printf("frames: %lld at %dx%d\n", ticks, width, height);
+    printf("triangles per frame: %.0f (particles included)\n", triangles / frames);
+    printf("scene: %.3f ms/frame\n", sceneSecs * 1000.0 / frames);
+    printf("raster: %.3f ms/frame\n", rasterSecs * 1000.0 / frames);
+    printf("frame: median %.3f ms, p99 %.3f ms, max %.3f ms (%.0f fps)\n",
+        sorted[sorted.size() / 2], sorted[sorted.size() * 99 / 100], sorted.back(),
+        frames / (sceneSecs + rasterSecs));
+    uint64_t hash = frameHash(sw);
+    printf("last frame hash: %016llx\n", (unsigned long long)hash);
+    if (written) printf("wrote %lld frames to %s*%s\n", written, out, png ? ".png" : ".ppm");
+    if (expect && strtoull(expect, nullptr, 16) != hash) {
+        printf("last frame doesn't match: expected %s\n", expect);
+        return 1;
+    }
+    return 0;
+}
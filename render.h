@@ -0,0 +1,28 @@
+#pragma once
+#include "geometry.h"
+
+// text lines a backend may keep between frames (the GL backend caches each
+// slot in a display list); TEXT_UNCACHED is drawn once and forgotten
+enum textSlot {
+    TEXT_UNCACHED = -1,
+    TEXT_SCORE, TEXT_ROUND, TEXT_ACCURACY, TEXT_GAME_OVER, TEXT_RESTART,
+    TEXT_SLOTS
+};
+
+// what a frame is drawn through: the window uses the GL backend (glrender.h),
+// headless capture and render benchmarks the CPU rasterizer (swrender.h).
+// Coordinates are the playfield's, 0..WIDTH x 0..HEIGHT with y up.
+struct renderer {
+    virtual ~renderer() {}
+
+    // fill the frame with black
+    virtual void clear() = 0;
+
+    // triangle list, alpha blended (src alpha, 1 - src alpha) in order
+    virtual void triangles(const vertex* v, int count) = 0;
+
+    // one line of text starting at (x, y) on the baseline; size is the font
+    // height in pixels (12 or 18)
+    virtual void text(int slot, const char* s, float x, float y, int size,
+        float r = 1.0f, float g = 1.0f, float b = 1.0f) = 0;
+};
@@ -0,0 +1,161 @@
+#include "replay.h"
+#include "waves.h"
+#include <cstdio>
+
+static const char MAGIC[4] = { 'S', 'I', 'R', 'P' };
+static const uint32_t VERSION = 2; // 2 added the wave table hash
+
+unsigned char packInput(const input& in) {
+    return (unsigned char)((in.left ? 1 : 0) | (in.right ? 2 : 0) | (in.fire ? 4 : 0) |
+        (in.pause ? 8 : 0) | (in.restart ? 16 : 0));
+}
+
+input unpackInput(unsigned char bits) {
+    input in;
+    in.left = (bits & 1) != 0;
+    in.right = (bits & 2) != 0;
+    in.fire = (bits & 4) != 0;
+    in.pause = (bits & 8) != 0;
+    in.restart = (bits & 16) != 0;
+    return in;
+}
+
+void replay::begin(const game& g) {
+    seed = g.seed;
+    waveRows = g.waveRows;
+    waveCols = g.waveCols;
+    alienFireOdds = g.alienFireOdds;
+    alienVolley = g.alienVolley;
+    waves = wavesHash(g);
+    version = VERSION;
+    inputs.clear();
+}
+
+void replay::start(game& g) const {
+    const waveDef* table = g.waves;
+    int count = g.waveCount;
+    g = game();
+    g.waves = table;
+    g.waveCount = count;
+    g.waveRows = waveRows;
+    g.waveCols = waveCols;
+    g.alienFireOdds = alienFireOdds;
+    g.alienVolley = alienVolley;
+    seedGame(g, seed);
+    resetGame(g);
+}
+
+const char* replay::checkWaves(const game& g) const {
+    uint64_t played = wavesHash(g);
+    if (waves == played) return nullptr;
+    if (!waves && version == 1)
+        return "it is a version 1 replay, from before wave files, and plays the built-in waves (drop --waves)";
+    if (!waves) return "it was recorded with the built-in waves (drop --waves)";
+    if (!played) return "it was recorded with a wave file (pass it with --waves)";
+    return "it was recorded with a different wave file";
+}
+
+// little-endian helpers so files move between machines
+static void putU32(std::vector<unsigned char>& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out.push_back((unsigned char)(v >> (i * 8)));
+}
+
+static void putU64(std::vector<unsigned char>& out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out.push_back((unsigned char)(v >> (i * 8)));
+}
+
+static void putVarint(std::vector<unsigned char>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((unsigned char)v);
+}
+
+bool replay::save(const char* path) const {
+    std::vector<unsigned char> out(MAGIC, MAGIC + 4);
+    putU32(out, VERSION);
+    putU64(out, seed);
+    putU32(out, (uint32_t)waveRows);
+    putU32(out, (uint32_t)waveCols);
+    putU32(out, (uint32_t)alienFireOdds);
+    putU32(out, (uint32_t)alienVolley);
+    putU64(out, waves);
+    putU64(out, inputs.size());
+
+    // runs of (input byte, length)
+    for (size_t i = 0; i < inputs.size(); ) {
+        size_t j = i;
+        while (j < inputs.size() && inputs[j] == inputs[i]) j++;
+        out.push_back(inputs[i]);
+        putVarint(out, j - i);
+        i = j;
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool replay::load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<unsigned char> data;
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    size_t pos = 0;
+    bool bad = false;
+    auto u32 = [&]() {
+        uint32_t v = 0;
+        if (pos + 4 > data.size()) { bad = true; return v; }
+        for (int i = 0; i < 4; i++) v |= (uint32_t)data[pos++] << (i * 8);
+        return v;
+    };
+    auto u64 = [&]() {
+        uint64_t v = 0;
+        if (pos + 8 > data.size()) { bad = true; return v; }
+        for (int i = 0; i < 8; i++) v |= (uint64_t)data[pos++] << (i * 8);
+        return v;
+    };
+    auto varint = [&]() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) { bad = true; return v; }
+            unsigned char b = data[pos++];
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        bad = true;
+        return v;
+    };
+
+    if (data.size() < 4 || data[0] != MAGIC[0] || data[1] != MAGIC[1] ||
+        data[2] != MAGIC[2] || data[3] != MAGIC[3])
+        return false;
+    pos = 4;
+    version = u32();
+    if (version < 1 || version > VERSION) return false;
+    seed = u64();
+    waveRows = (int)u32();
+    waveCols = (int)u32();
+    alienFireOdds = (int)u32();
+    alienVolley = (int)u32();
+    waves = version >= 2 ? u64() : 0; // version 1: the built-in waves
+    uint64_t ticks = u64();
+    if (bad || alienFireOdds < 1) return false;
+
+    inputs.clear();
+    inputs.reserve((size_t)ticks);
+    while (!bad && inputs.size() < ticks) {
+        if (pos >= data.size()) { bad = true; break; }
+        unsigned char bits = data[pos++];
+        uint64_t run = varint();
+        if (bad || run > ticks - inputs.size()) { bad = true; break; }
+        inputs.insert(inputs.end(), (size_t)run, bits);
+    }
+    return !bad;
+}
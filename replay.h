@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "sim.h"
+
+// one tick of input packed into a byte
+unsigned char packInput(const input& in);
+input unpackInput(unsigned char bits);
+
+// recorded session: the settings the game started with plus one input byte
+// per tick. On disk the inputs are run-length encoded, since keys are held
+// for many ticks at a time.
+struct replay {
+    uint64_t seed = 0;
+    int waveRows = ALIEN_ROWS, waveCols = ALIEN_COLS;
+    int alienFireOdds = 25, alienVolley = 1;
+    uint64_t waves = 0; // wavesHash() of the wave table it was played with;
+                        // version 1 files predate wave files and always mean the built-in waves
+    uint32_t version = 0; // of the file it was loaded from
+    std::vector<unsigned char> inputs;
+
+    // remember how g was set up (call right after seeding/resetting it)
+    void begin(const game& g);
+    void record(const input& in) { inputs.push_back(packInput(in)); }
+
+    // put g back into the recorded starting state; g keeps the wave table it
+    // was given, which has to be the one the replay was recorded with
+    void start(game& g) const;
+
+    // why g's wave table can't play this replay back, or nullptr when it can
+    const char* checkWaves(const game& g) const;
+
+    bool save(const char* path) const;
+    bool load(const char* path);
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+// small seeded PRNG (PCG32). Every copy is an independent, reproducible
+// stream, so simulation randomness can live inside the game state and
+// cosmetic effects can draw from their own stream without disturbing it.
+struct rng {
+    uint64_t state = 0x853c49e6748fea9bull;
+    uint64_t inc = 0xda3e39cb94b95bdbull;
+
+    void seed(uint64_t seed, uint64_t stream) {
+        state = 0;
+        inc = (stream << 1) | 1;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+    }
+
+    // 0 .. n - 1, used like rand() % n
+    int below(int n) {
+        return (int)(next() % (uint32_t)n);
+    }
+
+    // 0 .. 1 (exclusive), for cosmetic spread
+    float unit() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// stream ids, so the same seed gives unrelated sequences
+const uint64_t STREAM_GAMEPLAY = 1;
+const uint64_t STREAM_COSMETIC = 2;
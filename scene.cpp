@@ -0,0 +1,215 @@
+#include "scene.h"
+#include <cmath>
+#include <cstdio>
+#include "profiler.h"
+
+// sprite meshes, built once in buildMeshes()
+static mesh shieldMesh, playerMesh, alienMesh, playerBulletMesh, alienBulletMesh;
+static mesh powerupMesh[POWERUP_KINDS];
+
+static float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+void buildMeshes() {
+    // shield (blue, semi-transparent), relative to the player's base
+    shieldMesh.color(0.3f, 0.7f, 1.0f, 0.28f);
+    shieldMesh.ellipse(0, 16, 28, 28, 32);
+
+    // player: main body
+    mesh& p = playerMesh;
+    p.color(0.2f, 0.8f, 1.0f);
+    p.polygon({ -12, 16,  -18, 12,  -12, 4,  12, 4,  18, 12,  12, 16 });
+
+    // cockpit
+    p.color(0.3f, 0.3f, 1.0f);
+    p.ellipse(0, 16, 6, 8, 64, 32); // top half of a 64-gon
+
+    // nose
+    p.color(1.0f, 1.0f, 1.0f);
+    p.triangle(0, 34, -8, 16, 8, 16);
+
+    // wings
+    p.color(0.7f, 0.7f, 0.7f);
+    p.polygon({ -12, 12,  -28, 6,  -24, 2,  -12, 4 });
+    p.polygon({ 12, 12,  28, 6,  24, 2,  12, 4 });
+
+    // engines
+    p.color(0.8f, 0.4f, 0.1f);
+    p.polygon({ -22, 0,  -18, 0,  -18, 4,  -22, 4 });
+    p.polygon({ 18, 0,  22, 0,  22, 4,  18, 4 });
+
+    // highlights on body
+    p.color(0.8f, 1.0f, 1.0f);
+    p.line(0, 4, 0, 16);
+    p.line(-6, 8, -6, 14);
+    p.line(6, 8, 6, 14);
+
+    // alien: main hull (dark, spiky, compact)
+    mesh& a = alienMesh;
+    a.color(0.35f, 0.05f, 0.15f);
+    a.polygon({ 0, 10,  -10, 4,  -13, -4,  -6, -12,  0, -16,  6, -12,  13, -4,  10, 4 });
+
+    // cockpit
+    a.color(0.9f, 0.1f, 0.2f);
+    a.ellipse(0, -1, 3.5f, 3.5f, 14);
+
+    // side spikes
+    a.color(0.6f, 0.0f, 0.2f);
+    a.triangle(-13, -4, -18, -8, -6, -12);
+    a.triangle(13, -4, 18, -8, 6, -12);
+
+    // glowing spoons
+    a.color(1.0f, 0.9f, 0.2f);
+    a.ellipse(-4.5f, -7, 1.0f, 1.0f, 8);
+    a.ellipse(4.5f, -7, 1.0f, 1.0f, 8);
+
+    // lower mandibles (dark)
+    a.color(0.25f, 0.0f, 0.1f);
+    a.triangle(-3, -14, -1, -19, 0, -16);
+    a.triangle(3, -14, 1, -19, 0, -16);
+
+    // player bullet: outer glow + tip, pointing up
+    playerBulletMesh.color(0.2f, 1.0f, 1.0f, 0.18f);
+    playerBulletMesh.ellipse(0, 0, 5, 16, 16);
+    playerBulletMesh.color(0.8f, 1.0f, 1.0f);
+    playerBulletMesh.triangle(0, 14, -3, -8, 3, -8);
+
+    // alien bullet: unit circle, scaled and tinted per bullet
+    alienBulletMesh.ellipse(0, 0, 1, 1, 18);
+
+    // power-ups: an orb in the kind's color
+    for (int k = 0; k < POWERUP_KINDS; k++) {
+        mesh& m = powerupMesh[k];
+        float r = powerupKinds[k].r, g = powerupKinds[k].g, b = powerupKinds[k].b;
+        m.color(r, g, b, 0.18f); // outer glow
+        m.ellipse(0, 0, 14, 14, 24);
+        m.color(r, g, b);        // main orb
+        m.ellipse(0, 0, 8, 8, 20);
+        m.color(1.0f, 1.0f, 1.0f, 0.28f); // inner highlight
+        m.ellipse(0, 0, 4, 4, 12);
+    }
+}
+
+void drawPlayer(batch& out, const game& prev, const game& cur, float alpha, rng& cosmetic) {
+    PROFILE_SCOPE("draw: player");
+    float cx = lerp(prev.playerX, cur.playerX, alpha);
+    float baseY = 20.0f;
+
+    // draw shield if active
+    if (cur.effectActive(POWERUP_SHIELD))
+        out.add(shieldMesh, cx, baseY);
+
+    out.add(playerMesh, cx, baseY);
+
+    // engine flames (flicker effect)
+    out.triangle(cx - 20, baseY + 0, cx - 19, baseY - 8 - (float)cosmetic.below(4),
+        cx - 21, baseY - 8 - (float)cosmetic.below(4), 1.0f, 0.8f, 0.1f);
+    out.triangle(cx + 20, baseY + 0, cx + 19, baseY - 8 - (float)cosmetic.below(4),
+        cx + 21, baseY - 8 - (float)cosmetic.below(4), 1.0f, 0.8f, 0.1f);
+}
+
+void drawAliens(batch& out, const game& prev, const game& cur, float alpha) {
+    PROFILE_SCOPE("draw: aliens");
+    float alienX = lerp(prev.alienX, cur.alienX, alpha);
+    float alienY = lerp(prev.alienY, cur.alienY, alpha);
+    const formation& f = cur.aliens;
+    f.forEach([&](int y, int x) {
+        out.add(alienMesh, alienX + x * f.pitchX, alienY - y * f.pitchY);
+    });
+}
+
+void drawBullets(batch& out, const game& cur, float alpha) {
+    PROFILE_SCOPE("draw: bullets");
+
+    // bullets move a fixed amount per tick, so step back along their velocity
+    float back = 1.0f - alpha;
+
+    // player bullets, rotated so the tip points along (dx, dy)
+    const auto& pb = cur.playerBullets;
+    for (int i = 0; i < pb.size(); i++)
+        out.add(playerBulletMesh, pb.x[i], pb.y[i] - pb.speed[i] * back);
+
+    const auto& hb = cur.homingBullets;
+    for (int i = 0; i < hb.size(); i++) {
+        float step = hb.speed[i] * back;
+        out.add(playerBulletMesh, hb.x[i] - hb.dx[i] * step, hb.y[i] - hb.dy[i] * step,
+            1.0f, hb.dy[i], -hb.dx[i]);
+    }
+
+    // alien bullets (yellow)
+    const auto& ab = cur.alienBullets;
+    for (int i = 0; i < ab.size(); i++) {
+        float step = ab.speed[i] * back;
+        float bx = ab.x[i] - ab.dx[i] * step;
+        float by = ab.y[i] + ab.dy[i] * step;
+        float pulse = 1.0f + 0.3f * sin(by * 0.25f);
+        out.add(alienBulletMesh, bx, by, 7 * pulse, 1.0f, 0.0f,
+            0.6f + 0.3f * pulse, 1.0f - 0.4f * pulse, 0.1f);
+    }
+}
+
+void drawPowerups(batch& out, const game& cur, float alpha) {
+    PROFILE_SCOPE("draw: power-ups");
+    float back = (1.0f - alpha) * 2.0f; // power-ups fall 2px per tick
+    for (int i = 0; i < cur.pickups.size(); i++) {
+        const position* p = cur.positions.get(cur.pickups.owner[i]);
+        out.add(powerupMesh[cur.pickups[i].kind], p->x, p->y + back);
+    }
+}
+
+void drawScene(batch& out, const game& prev, const game& cur, float alpha, rng& cosmetic) {
+    out.clear();
+    drawPlayer(out, prev, cur, alpha, cosmetic);
+    drawAliens(out, prev, cur, alpha);
+    drawBullets(out, cur, alpha);
+    drawPowerups(out, cur, alpha);
+}
+
+void hud::draw(renderer& r, const game& g) {
+    PROFILE_SCOPE("draw: hud");
+
+    // only reformat what changed; backends keep each slot between frames
+    if (g.score != score) {
+        score = g.score;
+        snprintf(scoreText, sizeof(scoreText), "SCORE: %d", g.score);
+    }
+    if (g.round != round) {
+        round = g.round;
+        snprintf(roundText, sizeof(roundText), "ROUND: %d", g.round);
+    }
+    if (g.hits != hits || g.totalShots != shots) {
+        hits = g.hits;
+        shots = g.totalShots;
+
+        // shot accuracy
+        float accuracy = g.totalShots > 0 ?
+            (static_cast<float>(g.hits) / g.totalShots) * 100.0f : 0.0f;
+        snprintf(accuracyText, sizeof(accuracyText), "ACCURACY: %.1f%%", accuracy);
+    }
+
+    r.text(TEXT_SCORE, scoreText, 10, HEIGHT - 30, 18);
+    r.text(TEXT_ROUND, roundText, WIDTH / 2 - 50, HEIGHT - 30, 18);
+    r.text(TEXT_ACCURACY, accuracyText, WIDTH - 190, HEIGHT - 30, 18);
+
+    // game over
+    if (g.gameOver) {
+        r.text(TEXT_GAME_OVER, "GAME OVER", WIDTH / 2 - 60, HEIGHT / 2, 18);
+        r.text(TEXT_RESTART, "PRESS ENTER TO RESTART", WIDTH / 2 - 70, HEIGHT / 2 - 30, 12);
+    }
+}
+
+void renderFrame(renderer& r, batch& out, hud& h, const game& prev, const game& cur, float alpha, rng& cosmetic,
+    const particleSystem* effects) {
+    r.clear();
+    drawScene(out, prev, cur, alpha, cosmetic);
+    if (effects) {
+        PROFILE_SCOPE("draw: particles");
+        effects->draw(out);
+    }
+    {
+        PROFILE_SCOPE("draw: submit");
+        r.triangles(out.verts.data(), (int)out.verts.size());
+    }
+    h.draw(r, cur);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "geometry.h"
+#include "particles.h"
+#include "render.h"
+#include "rng.h"
+#include "sim.h"
+
+// what a frame shows, independent of how it gets drawn: the playfield as one
+// triangle batch plus the HUD text, interpolated between the last two ticks
+
+// build the sprite meshes, once before the first frame
+void buildMeshes();
+
+// player, aliens, bullets and power-ups at alpha between prev (0) and cur (1);
+// cosmetic drives the engine flicker
+void drawScene(batch& out, const game& prev, const game& cur, float alpha, rng& cosmetic);
+
+// the parts drawScene() is made of, each appending to out
+void drawPlayer(batch& out, const game& prev, const game& cur, float alpha, rng& cosmetic);
+void drawAliens(batch& out, const game& prev, const game& cur, float alpha);
+void drawBullets(batch& out, const game& cur, float alpha);
+void drawPowerups(batch& out, const game& cur, float alpha);
+
+// score, round and accuracy along the top, game over message in the middle;
+// the lines are only reformatted when a value changes
+struct hud {
+    void draw(renderer& r, const game& g);
+
+private:
+    int score = -1, round = -1, hits = -1, shots = -1;
+    char scoreText[32] = "", roundText[32] = "", accuracyText[32] = "";
+};
+
+// a whole frame: clear, the scene batch (rebuilt into out, with the
+// particles on top when given) and the HUD
+void renderFrame(renderer& r, batch& out, hud& h, const game& prev, const game& cur, float alpha, rng& cosmetic,
+    const particleSystem* effects = nullptr);
@@ -0,0 +1,601 @@
+#include "sim.h"
+#include "broadphase.h"
+#include "profiler.h"
+#include "targeting.h"
+#include "waves.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+void seedGame(game& g, uint64_t seed) {
+    g.seed = seed;
+    g.random.seed(seed, STREAM_GAMEPLAY);
+}
+
+int finalRound(const game& g) {
+    return g.waves ? g.waveCount : BUILTIN_ROUNDS;
+}
+
+// the built-in layout leaves the formation this much room: column centres
+// within FORMATION_SPAN_X, the top row at most at FORMATION_TOP and the bottom
+// row no lower than FORMATION_BOTTOM, well above the invasion line
+const float FORMATION_SPAN_X = 700;
+const float FORMATION_TOP = HEIGHT - 40;
+const float FORMATION_BOTTOM = 160;
+
+void builtinLayout(formation& f, float& startX, float& startY) {
+    f.pitchX = 60;
+    f.pitchY = 40;
+    if (f.cols > 1) f.pitchX = std::min(f.pitchX, FORMATION_SPAN_X / (f.cols - 1));
+    startX = 50;
+    startY = std::min(FORMATION_TOP, std::max(400.0f, FORMATION_BOTTOM + (f.rows - 1) * f.pitchY));
+    if (f.rows > 1) f.pitchY = std::min(f.pitchY, (startY - FORMATION_BOTTOM) / (f.rows - 1));
+}
+
+// bring the formation in for g.round
+static void startWave(game& g) {
+    formation& f = g.aliens;
+    g.aliensRight = true;
+    if (g.waves) {
+        const waveDef& w = g.waves[std::min(g.round, g.waveCount) - 1];
+        f.reset(w.rows, w.cols);
+        f.pitchX = w.pitchX;
+        f.pitchY = w.pitchY;
+        g.alienX = w.startX;
+        g.alienY = w.startY;
+        g.alienSpeed = w.speed;
+        g.alienFireOdds = w.fireOdds;
+        g.alienVolley = w.volley;
+        g.alienBulletSpeed = w.bulletSpeed;
+        g.alienFirePattern = w.pattern;
+        std::copy(w.dropOdds, w.dropOdds + POWERUP_KINDS, g.dropOdds);
+        return;
+    }
+    f.reset(g.waveRows, g.waveCols);
+    builtinLayout(f, g.alienX, g.alienY);
+    g.alienSpeed = g.round == 1 ? BUILTIN_ALIEN_SPEED : g.alienSpeed * g.roundSpeedUp;
+    g.alienBulletSpeed = ALIEN_BULLET_SPEED;
+    g.alienFirePattern = builtinFirePattern(g.round);
+}
+
+// everything a game played changes goes back to the start; the rng stream
+// and the settings (wave table or size, fire odds, balance knobs) are kept
+void resetGame(game& g) {
+    g.playerX = WIDTH / 2;
+    g.leftPressed = false;
+    g.rightPressed = false;
+    g.playerBullets.clear();
+    g.homingBullets.clear();
+    g.alienBullets.clear();
+    g.score = 0;
+    g.paused = false;
+    g.gameOver = false;
+    g.ended = END_NONE;
+    g.round = 1;
+    g.totalShots = 0;
+    g.hits = 0;
+    std::fill(g.effectTimer, g.effectTimer + POWERUP_KINDS, 0);
+    g.pickups.clear();
+    g.velocities.clear();
+    g.positions.clear();
+    g.entities.clear();
+    g.events.clear();
+    g.playerMoved = 0;
+    g.alienMovedX = g.alienMovedY = 0;
+    startWave(g);
+}
+
+void shoot(game& g) {
+    g.totalShots++;
+    if (g.effectActive(POWERUP_HOMING)) {
+        g.homingBullets.push(g.playerX, MUZZLE_Y, SHOT_SPEED);
+    }
+    else {
+        g.playerBullets.push(g.playerX, MUZZLE_Y, SHOT_SPEED);
+    }
+}
+// player bullets vs aliens: the formation is a rigid lattice anchored at
+// (alienX, alienY), so each bullet is only tested against the cells its path
+// (relative to the formation, which moved too) can reach
+template <int N>
+static void hitAliens(game& g, bulletStream<N>& s) {
+    unsigned char keep[N];
+    float mx[N], my[N];
+    int n = s.size();
+    if (n == 0) return;
+    std::fill(keep, keep + n, 1);
+    for (int i = 0; i < n; i++) {
+        mx[i] = s.moveX(i, 1.0f) - g.alienMovedX;
+        my[i] = s.moveY(i, 1.0f, 1.0f) - g.alienMovedY;
+    }
+
+    int kills = hitFormation(g.aliens, g.alienX, g.alienY, n, s.x, s.y, mx, my, keep, [&g](float ax, float ay) {
+        // a roll per power-up kind, in kind order (odds of 0 turn a drop off)
+        for (int k = 0; k < POWERUP_KINDS; k++) {
+            if (g.dropOdds[k] > 0 && g.random.below(g.dropOdds[k]) == 0)
+                spawnPowerup(g, k, ax, ay);
+        }
+
+        g.score += 100;
+        g.hits++;
+        g.events.push_back({ ax, ay, EVENT_KILL, 0 });
+    });
+
+    if (kills > 0) s.compact(keep);
+}
+
+// where the player goes over a step, for timing the alien shots against it.
+// Its move per tick only changes at a wall, so a step splits into a few parts
+// of steady motion: part k runs from tick[k] at x[k] to tick[k + 1] at x[k + 1]
+struct playerPath {
+    static const int MAX_PARTS = 4;
+    int parts = 0;
+    int tick[MAX_PARTS + 1];
+    float x[MAX_PARTS + 1];
+};
+
+// the alien shots over a step: step() moves them to where they are on the
+// step's last tick up front and works out the tick each one reaches the
+// player (due, 0 for never, -1 once the shield ate it), so the ticks in
+// between only look at the few listed in hitting
+struct shotSchedule {
+    int ticks = 1;
+    playerPath path;
+    int due[MAX_ALIEN_BULLETS];
+    int hitting[MAX_ALIEN_BULLETS];
+    int hittingCount = 0;
+};
+
+static thread_local shotSchedule shots;
+
+// everything but the aliens only matters near the player, so it gets bucketed
+// and the player's cells queried
+static thread_local pointGrid grid;
+static thread_local int near[MAX_ALIEN_BULLETS];
+
+static float keepOnScreen(float playerX) {
+    return std::max(PLAYER_HALF_WIDTH, std::min((float)WIDTH - PLAYER_HALF_WIDTH, playerX));
+}
+
+// the player's path over the next ticks ticks with the keys held now, moved
+// the way movePlayer() will move it
+static void planPath(const game& g, int ticks, playerPath& p) {
+    p.parts = 0;
+    p.tick[0] = 0;
+    p.x[0] = g.playerX;
+    float x = g.playerX;
+    int last = -1;
+    for (int t = 1; t <= ticks; t++) {
+        float was = x;
+        if (g.leftPressed) x -= g.playerSpeed;
+        if (g.rightPressed) x += g.playerSpeed;
+        float free = x;
+        x = keepOnScreen(x);
+        int kind = x == was ? 0 : x == free ? 1 : 2; // standing, moving, stopped short at a wall
+        if (kind != last && p.parts < playerPath::MAX_PARTS) p.parts++;
+        last = kind;
+        p.tick[p.parts] = t;
+        p.x[p.parts] = x;
+    }
+}
+
+// the tick after tick from on which alien shot i (where it is on the step's
+// last tick) reaches the player, 0 if it doesn't this step: a swept test per
+// part of the player's path, relative to the player
+static int dueTick(const bulletStream<MAX_ALIEN_BULLETS>& ab, int i, int from) {
+    const playerPath& p = shots.path;
+    for (int k = 0; k < p.parts; k++) {
+        int a = std::max(from, p.tick[k]), b = p.tick[k + 1];
+        if (a >= b) continue;
+        float late = (float)(shots.ticks - b), span = (float)(b - a);
+        float x = ab.x[i] - ab.moveX(i, late);
+        float y = ab.y[i] - ab.moveY(i, -1.0f, late);
+        float fromX = p.x[k];
+        if (a > p.tick[k]) fromX += (p.x[k + 1] - p.x[k]) * (float)(a - p.tick[k]) / (float)(b - p.tick[k]);
+        float px1 = p.x[k + 1] - PLAYER_HALF_WIDTH, px2 = p.x[k + 1] + PLAYER_HALF_WIDTH;
+        float t;
+        if (sweptEntry(x, y, ab.moveX(i, span) - (p.x[k + 1] - fromX), ab.moveY(i, -1.0f, span),
+                px1, PLAYER_BOTTOM, px2, PLAYER_TOP, t))
+            return std::min(b, a + 1 + (int)(t * span));
+        if (x > px1 && x < px2 && y > PLAYER_BOTTOM && y < PLAYER_TOP) return b;
+    }
+    return 0;
+}
+
+// list the alien shots (already moved ticks ticks on) that reach the player
+// along shots.path; the grid holds where they ended up, so the query covers
+// the whole path and reaches as far back as the fastest could have come from
+static void findShots(game& g, int ticks) {
+    const auto& ab = g.alienBullets;
+    const playerPath& p = shots.path;
+    shots.ticks = ticks;
+    float lo = *std::min_element(p.x, p.x + p.parts + 1);
+    float hi = *std::max_element(p.x, p.x + p.parts + 1);
+    float fastest = 0;
+    for (int i = 0; i < ab.size(); i++) fastest = std::max(fastest, ab.speed[i]);
+    float reach = fastest * (float)ticks;
+    const float* bx = ab.x;
+    const float* by = ab.y;
+    shots.hittingCount = pointsInBox(grid, ab.size(),
+        [bx](int i) { return bx[i]; }, [by](int i) { return by[i]; },
+        lo - PLAYER_HALF_WIDTH - reach, PLAYER_BOTTOM - reach, hi + PLAYER_HALF_WIDTH + reach, PLAYER_TOP + reach,
+        [&](int i) {
+            shots.due[i] = dueTick(ab, i, 0);
+            return shots.due[i] > 0;
+        }, shots.hitting);
+}
+
+// alien shots reaching the player on the given tick of the step: the shield
+// eats them, otherwise they end the game
+static void shotsAtPlayer(game& g, int tick) {
+    const auto& ab = g.alienBullets;
+    bool shield = g.effectActive(POWERUP_SHIELD);
+    float late = (float)(shots.ticks - tick);
+    for (int k = 0; k < shots.hittingCount; k++) {
+        int i = shots.hitting[k];
+        if (shots.due[i] != tick) continue;
+        if (shield) {
+            shots.due[i] = -1;
+            g.events.push_back({ ab.x[i] - ab.moveX(i, late), ab.y[i] - ab.moveY(i, -1.0f, late), EVENT_SHIELD_BLOCK, 0 });
+        }
+        else {
+            g.gameOver = true;
+            g.ended = END_SHOT;
+        }
+    }
+}
+
+// the alien shot stream filled up on a tick after the step's first: a tick at
+// a time, the shots eaten or off screen by the tick before would be gone
+// already, so drop those and renumber the ones still due
+static void reclaimShots(game& g, int tick) {
+    static thread_local unsigned char keep[MAX_ALIEN_BULLETS];
+    static thread_local int moved[MAX_ALIEN_BULLETS];
+    auto& ab = g.alienBullets;
+    int n = ab.size(), kept = 0;
+    float late = (float)(shots.ticks - (tick - 1));
+    for (int i = 0; i < n; i++) keep[i] = ab.y[i] - ab.moveY(i, -1.0f, late) >= 0;
+    for (int k = 0; k < shots.hittingCount; k++)
+        if (shots.due[shots.hitting[k]] < 0) keep[shots.hitting[k]] = 0;
+    for (int i = 0; i < n; i++) {
+        moved[i] = kept;
+        shots.due[kept] = shots.due[i];
+        kept += keep[i];
+    }
+    int h = 0;
+    for (int k = 0; k < shots.hittingCount; k++)
+        if (keep[shots.hitting[k]]) shots.hitting[h++] = moved[shots.hitting[k]];
+    shots.hittingCount = h;
+    ab.compact(keep);
+}
+
+// the step ended after tick last: put the alien shots where they are then
+// (short of the step's end if the game ended early) and clear away the eaten
+// and off-screen ones
+static void settleShots(game& g, int last) {
+    static thread_local unsigned char keep[MAX_ALIEN_BULLETS];
+    auto& ab = g.alienBullets;
+    if (last < shots.ticks) ab.advance(-1.0f, (float)(last - shots.ticks));
+    bool eaten = false;
+    std::fill(keep, keep + ab.size(), 1);
+    for (int k = 0; k < shots.hittingCount; k++) {
+        if (shots.due[shots.hitting[k]] < 0) {
+            keep[shots.hitting[k]] = 0;
+            eaten = true;
+        }
+    }
+    if (eaten) ab.compact(keep);
+    ab.cull(0, FLT_MAX);
+    shots.hittingCount = 0;
+}
+
+// power-up collection, over the pickups' positions and moves gathered into
+// flat arrays; the pickup box runs from the floor up to y 60
+static void collectPickups(game& g) {
+    static thread_local float pickupX[MAX_POWERUPS], pickupY[MAX_POWERUPS];
+    static thread_local float pickupMX[MAX_POWERUPS], pickupMY[MAX_POWERUPS];
+    int pickups = g.pickups.size();
+    float reach = fabs(g.playerMoved);
+    for (int i = 0; i < pickups; i++) {
+        entity e = g.pickups.owner[i];
+        const position* p = g.positions.get(e);
+        const velocity* v = g.velocities.get(e);
+        pickupX[i] = p->x;
+        pickupY[i] = p->y;
+        pickupMX[i] = v ? v->dx - g.playerMoved : -g.playerMoved;
+        pickupMY[i] = v ? v->dy : 0.0f;
+        reach = std::max(reach, std::fabs(pickupMX[i]) + std::fabs(pickupMY[i]));
+    }
+    const float* ux = pickupX;
+    const float* uy = pickupY;
+    int nearCount = pointsInBox(grid, pickups,
+        [ux](int i) { return ux[i]; }, [uy](int i) { return uy[i]; },
+        g.playerX - 20 - reach, -reach, g.playerX + 20 + reach, 60 + reach, [&](int i) {
+            if (fabs(ux[i] - g.playerX) < 20 && uy[i] >= 0 && uy[i] < 60) return true;
+            float t;
+            return sweptEntry(ux[i], uy[i], pickupMX[i], pickupMY[i], g.playerX - 20, 0, g.playerX + 20, 60, t);
+        }, near);
+
+    // collect back to front, so the swap-removes never move a pickup still to visit
+    for (int k = nearCount - 1; k >= 0; k--) {
+        int i = near[k];
+        int kind = g.pickups[i].kind;
+        g.events.push_back({ ux[i], uy[i], EVENT_POWERUP, kind });
+        g.effectTimer[kind] = g.effectTicks[kind];
+        destroyEntity(g, g.pickups.owner[i]);
+    }
+}
+
+// collisions on the given tick of the step
+static void collide(game& g, int tick) {
+    PROFILE_SCOPE("sim: collisions");
+
+    hitAliens(g, g.playerBullets);
+    hitAliens(g, g.homingBullets);
+    shotsAtPlayer(g, tick);
+    collectPickups(g);
+}
+
+void checkCollisions(game& g) {
+    // a one-tick step whose moves are done: the player came from playerMoved back
+    playerPath& p = shots.path;
+    p.parts = 1;
+    p.tick[0] = 0;
+    p.tick[1] = 1;
+    p.x[0] = g.playerX - g.playerMoved;
+    p.x[1] = g.playerX;
+    findShots(g, 1);
+    collide(g, 1);
+    settleShots(g, 1);
+}
+
+entity spawnPowerup(game& g, int kind, float x, float y) {
+    if (g.pickups.full()) return NO_ENTITY;
+    entity e = g.entities.create();
+    if (e == NO_ENTITY) return NO_ENTITY;
+    g.positions.add(e, { x, y });
+    g.velocities.add(e, { 0.0f, -2.0f });
+    g.pickups.add(e, { kind });
+    return e;
+}
+
+void destroyEntity(game& g, entity e) {
+    g.positions.remove(e);
+    g.velocities.remove(e);
+    g.pickups.remove(e);
+    g.entities.destroy(e);
+}
+
+static void tickPowerups(game& g) {
+    PROFILE_SCOPE("sim: power-ups");
+
+    for (int k = 0; k < POWERUP_KINDS; k++)
+        g.effectTimer[k] = std::max(0, g.effectTimer[k] - 1);
+
+    // move everything with a velocity
+    for (int i = 0; i < g.velocities.size(); i++) {
+        position* p = g.positions.get(g.velocities.owner[i]);
+        p->x += g.velocities[i].dx;
+        p->y += g.velocities[i].dy;
+    }
+}
+
+// pickups that fell off the bottom, after collection had its chance at them;
+// back to front for the same reason as collection
+static void cullPowerups(game& g) {
+    for (int i = g.pickups.size() - 1; i >= 0; i--) {
+        entity e = g.pickups.owner[i];
+        if (g.positions.get(e)->y < 0) destroyEntity(g, e);
+    }
+}
+
+static void movePlayer(game& g) {
+    PROFILE_SCOPE("sim: player");
+
+    // player movement
+    float x = g.playerX;
+    if (g.leftPressed) g.playerX -= g.playerSpeed;
+    if (g.rightPressed) g.playerX += g.playerSpeed;
+    g.playerX = keepOnScreen(g.playerX);
+    g.playerMoved = g.playerX - x;
+}
+
+static void moveAliens(game& g) {
+    PROFILE_SCOPE("sim: aliens");
+    formation& f = g.aliens;
+
+    // round system check
+    if (f.empty()) {
+        g.round++;
+        startWave(g);
+
+        // clear bullets, and with them the alien shots due at the player
+        g.playerBullets.clear();
+        g.homingBullets.clear();
+        g.alienBullets.clear();
+        shots.hittingCount = 0;
+    }
+
+    // alien movement
+    float x = g.alienX, y = g.alienY;
+    float leftEdge = g.alienX + f.leftColumn() * f.pitchX - ALIEN_HALF_SIZE;
+    float rightEdge = g.alienX + f.rightColumn() * f.pitchX + ALIEN_HALF_SIZE;
+    if (g.aliensRight) {
+        g.alienX += g.alienSpeed;
+        if (rightEdge > WIDTH - FORMATION_MARGIN) {
+            g.aliensRight = false;
+            g.alienY -= FORMATION_DROP;
+        }
+    }
+    else {
+        g.alienX -= g.alienSpeed;
+        if (leftEdge < FORMATION_MARGIN) {
+            g.aliensRight = true;
+            g.alienY -= FORMATION_DROP;
+        }
+    }
+    g.alienMovedX = g.alienX - x;
+    g.alienMovedY = g.alienY - y;
+}
+
+void steerHoming(game& g) {
+    PROFILE_SCOPE("sim: homing");
+    formation& f = g.aliens;
+
+    // homing bullets: resolve every bullet's target in one batch, then steer
+    static thread_local targetIndex targets;
+    static thread_local float tx[MAX_HOMING_BULLETS], ty[MAX_HOMING_BULLETS];
+    static thread_local unsigned char found[MAX_HOMING_BULLETS];
+    auto& hb = g.homingBullets;
+    int nh = hb.size();
+    if (nh > 0) {
+        targets.update(f);
+        targets.nearest(g.alienX, g.alienY, hb.x, hb.y, nh, tx, ty, found);
+
+        for (int i = 0; i < nh; i++) {
+            if (!found[i]) continue;
+            float vx = tx[i] - hb.x[i], vy = ty[i] - hb.y[i];
+            float len = sqrt(vx * vx + vy * vy);
+            if (len > 1e-2) {
+                vx /= len; vy /= len;
+                float dx = hb.dx[i] * 0.85f + vx * 0.15f;
+                float dy = hb.dy[i] * 0.85f + vy * 0.15f;
+                float dlen = sqrt(dx * dx + dy * dy);
+                hb.dx[i] = dx / dlen;
+                hb.dy[i] = dy / dlen;
+            }
+        }
+    }
+}
+
+static void moveBullets(game& g) {
+    PROFILE_SCOPE("sim: bullets");
+
+    // move the player's bullets up; the alien shots went the whole step at the
+    // start of it
+    g.playerBullets.advance(1.0f, 1.0f);
+    g.homingBullets.advance(1.0f, 1.0f);
+}
+
+static void cullBullets(game& g) {
+    PROFILE_SCOPE("sim: cull");
+
+    // remove off-screen bullets (the alien shots' turn comes at the end of the step)
+    g.playerBullets.cull(-FLT_MAX, HEIGHT);
+    g.homingBullets.cull(-FLT_MAX, HEIGHT);
+}
+
+void alienFire(game& g, int tick, int ticks) {
+    PROFILE_SCOPE("sim: alien fire");
+    formation& f = g.aliens;
+
+    // alien shooting (random alive alien). Alien shots are kept where they'll
+    // be on the step's last tick, so one fired before that starts out ahead
+    // by the ticks left, and gets its due tick at the player right away
+    if (g.random.below(g.alienFireOdds) != 0) return; // adjust for more/less frequent shooting
+    auto& ab = g.alienBullets;
+    float late = (float)(ticks - tick);
+    for (int v = 0; v < g.alienVolley && !f.empty(); v++) {
+        float alienBulletSpeed = g.alienBulletSpeed;
+        if (g.effectActive(POWERUP_SLOW)) alienBulletSpeed *= SLOW_BULLET_FACTOR;
+        int ay, ax;
+        f.nth(g.random.below(f.alive), ay, ax);
+
+        float dx, dy;
+        fireDirection(g.random, g.alienFirePattern, dx, dy);
+        if (ab.size() == MAX_ALIEN_BULLETS && tick > 1) reclaimShots(g, tick);
+        bool fired = ab.push(
+            g.alienX + ax * f.pitchX + dx * alienBulletSpeed * late,
+            g.alienY - ay * f.pitchY - dy * alienBulletSpeed * late,
+            alienBulletSpeed,
+            dx, dy
+            );
+        if (!fired || tick == ticks) continue;
+        int i = ab.size() - 1;
+        shots.due[i] = dueTick(ab, i, tick);
+        if (shots.due[i] > 0) shots.hitting[shots.hittingCount++] = i;
+    }
+}
+
+void fireDirection(rng& random, int pattern, float& dx, float& dy) {
+    dx = 0.0f;
+    dy = 1.0f;
+    if (pattern == FIRE_SPREAD) {
+        int dir = random.below(3); // 0: left-diagonal, 1: straight, 2: right-diagonal
+        if (dir == 0) dx = -0.7f;
+        else if (dir == 2) dx = 0.7f;
+        // dy stays 1.0f
+        float norm = sqrt(dx * dx + dy * dy);
+        dx /= norm; dy /= norm; // normalize so speed stays consistent
+    }
+}
+
+static void checkInvasion(game& g) {
+    PROFILE_SCOPE("sim: game over");
+    formation& f = g.aliens;
+
+    // game over condition: aliens reach player area (only the lowest alive row matters)
+    if (!f.empty()) {
+        float ay = g.alienY - f.bottomRow() * f.pitchY;
+        if (ay - ALIEN_HALF_SIZE < INVASION_LINE && !g.gameOver) { // approaching player
+            g.gameOver = true;
+            g.ended = END_INVADED;
+        }
+    }
+}
+
+// the last round was cleared on the tick before: the game ends here
+static void checkCleared(game& g) {
+    if (g.round > finalRound(g)) {
+        g.round--;
+        g.gameOver = true;
+        g.ended = END_CLEARED;
+    }
+}
+
+int step(game& g, const input& in, int ticks) {
+    g.events.clear();
+
+    // input gathered since the last tick
+    if (in.pause) g.paused = !g.paused;
+    if (in.restart && g.gameOver) resetGame(g);
+    g.leftPressed = in.left;
+    g.rightPressed = in.right;
+    if (in.fire && !g.gameOver) shoot(g);
+
+    // ending on a cleared last round uses up the tick it's found on
+    bool over = g.gameOver;
+    checkCleared(g);
+    if (g.gameOver) return over ? 0 : 1;
+    if (g.paused) return ticks;
+
+    // the alien shots go the whole step at once, everything else a tick at a
+    // time; bullets and pickups leave the screen only after the swept tests
+    // had a go at them
+    planPath(g, ticks, shots.path);
+    g.alienBullets.advance(-1.0f, (float)ticks);
+    findShots(g, ticks);
+    int tick = 0;
+    while (tick < ticks && !g.gameOver) {
+        if (tick > 0) {
+            checkCleared(g);
+            if (g.gameOver) {
+                settleShots(g, tick);
+                return tick + 1;
+            }
+        }
+        tick++;
+        tickPowerups(g);
+        movePlayer(g);
+        moveAliens(g);
+        steerHoming(g);
+        moveBullets(g);
+        alienFire(g, tick, ticks);
+        collide(g, tick);
+        cullBullets(g);
+        cullPowerups(g);
+        checkInvasion(g);
+    }
+    settleShots(g, tick);
+    return tick;
+}
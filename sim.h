@@ -0,0 +1,244 @@
+#pragma once
+#include "bullets.h"
+#include "ecs.h"
+#include "formation.h"
+#include "pool.h"
+#include "rng.h"
+
+// game constants
+const int WIDTH = 1000;
+const int HEIGHT = 600;
+const int ALIEN_ROWS = 4; // default wave size
+const int ALIEN_COLS = 8;
+const int TICK_RATE = 60; // simulation ticks per second
+const int BUILTIN_ROUNDS = 15; // rounds in the built-in progression
+
+// rules shared by step() and the lane kernel (lanes.h)
+const float ALIEN_HALF_SIZE = 15;   // alien hit box half width and height
+const float SHOT_HALF_WIDTH = 2;    // player shot hit box
+const float SHOT_HALF_HEIGHT = 8;
+const float SHOT_SPEED = 8;         // player shot px per tick
+const float MUZZLE_Y = 50;          // where player shots start
+const float PLAYER_HALF_WIDTH = 20; // player hit box, also how close it gets to a side
+const float PLAYER_BOTTOM = 20;
+const float PLAYER_TOP = 50;
+const float FORMATION_MARGIN = 10;  // the formation turns this close to a side
+const float FORMATION_DROP = 20;    // and comes down this far
+const float INVASION_LINE = 60;     // the game is lost once an alien dips below it
+const float BUILTIN_ALIEN_SPEED = 0.5f; // round 1 of the built-in progression
+const int SPREAD_FIRE_ROUND = 6;    // built-in progression: spread fire from this round
+
+// entity pools are sized up front so steady-state play never touches the heap;
+// anything spawned while a pool is full is dropped
+const int MAX_PLAYER_BULLETS = 128;
+const int MAX_HOMING_BULLETS = 128;
+const int MAX_ALIEN_BULLETS = 4096;
+const int MAX_POWERUPS = 64;
+const int MAX_ENTITIES = 256;
+const int MAX_EVENTS = 256;
+
+// player input for a single simulation tick
+struct input {
+    bool left = false;
+    bool right = false;
+    bool fire = false;    // shoot once this tick
+    bool pause = false;   // toggle pause
+    bool restart = false; // restart after game over
+};
+
+// how a game ended
+enum endReason {
+    END_NONE,    // still running
+    END_INVADED, // aliens reached the player
+    END_SHOT,    // hit by an alien bullet without a shield
+    END_CLEARED, // last round cleared
+};
+
+// power-up kinds; each one is a timed effect the player picks up. What a
+// kind looks like and how it drops is data (powerupKinds), the sim only asks
+// whether an effect is active where it applies
+enum powerupKind {
+    POWERUP_SLOW,   // alien bullets slow down
+    POWERUP_HOMING, // player shots steer toward aliens
+    POWERUP_SHIELD, // alien bullets that reach the player are absorbed
+    POWERUP_KINDS
+};
+
+struct powerupInfo {
+    const char* name;
+    int dropOdds;   // default 1 in N chance per kill, 0 = never
+    int ticks;      // default effect duration
+    float r, g, b;  // pickup and particle color
+};
+
+const powerupInfo powerupKinds[POWERUP_KINDS] = {
+    { "slow", 10, 200, 0.3f, 1.0f, 0.7f },   // ~3s at TICK_RATE
+    { "homing", 10, 200, 1.0f, 0.0f, 0.2f }, // ~3s at TICK_RATE
+    { "shield", 20, 600, 0.5f, 0.7f, 1.0f }, // 10s at TICK_RATE
+};
+
+// how aliens aim their shots
+enum firePattern {
+    FIRE_STRAIGHT, // straight down
+    FIRE_SPREAD,   // straight or diagonally left/right, picked per shot
+    FIRE_PATTERNS
+};
+
+// alien bullet px per tick in the built-in progression
+const float ALIEN_BULLET_SPEED = 4.0f;
+
+// alien bullets move at this fraction of their speed while slowed
+const float SLOW_BULLET_FACTOR = 0.375f;
+
+struct waveDef; // waves.h
+
+// components of the entities in game (anything that isn't a bullet or part of
+// the formation; today the falling power-up pickups)
+struct position { float x, y; };
+struct velocity { float dx, dy; }; // px per tick
+struct pickup { int kind; };       // collected by touching the player
+
+// something visible that happened during a tick, for effects; the simulation
+// only writes these and never reads them back
+enum eventKind {
+    EVENT_KILL,         // alien destroyed at (x, y)
+    EVENT_SHIELD_BLOCK, // alien bullet absorbed by the shield at (x, y)
+    EVENT_POWERUP,      // power-up of the given type collected at (x, y)
+};
+
+struct simEvent {
+    float x, y;
+    int kind;
+    int type; // powerupKind for EVENT_POWERUP
+};
+
+// game state
+struct game {
+
+    // all gameplay randomness comes from here, so a seed plus the inputs
+    // reproduce a session exactly
+    uint64_t seed = 0;
+    rng random;
+
+    // player
+    float playerX = WIDTH / 2;
+    static constexpr float playerSpeed = 5.0f;
+    bool leftPressed = false;
+    bool rightPressed = false;
+
+    // aliens
+    float alienX = 50;
+    float alienY = 400;
+    float alienSpeed = 0.5f;
+    bool aliensRight = true;
+
+    // aliens alive state
+    formation aliens;
+
+    // progression: with a wave table (waves.h) every round is set up from its
+    // wave and the game ends after the last; without one the built-in progression runs
+    // BUILTIN_ROUNDS rounds of the waveRows x waveCols formation, each
+    // roundSpeedUp times faster, with spread fire from round 6
+    const waveDef* waves = nullptr;
+    int waveCount = 0;
+    int waveRows = ALIEN_ROWS;
+    int waveCols = ALIEN_COLS;
+
+    // alien fire: each tick 1 in alienFireOdds chance that alienVolley aliens shoot
+    int alienFireOdds = 25;
+    int alienVolley = 1;
+    float alienBulletSpeed = ALIEN_BULLET_SPEED;
+    int alienFirePattern = FIRE_STRAIGHT;
+
+    // balance: formation speed-up per round, and per power-up kind the drop
+    // odds (1 in N per kill, 0 = never) and effect duration in ticks
+    float roundSpeedUp = 1.25f;
+    int dropOdds[POWERUP_KINDS] = { powerupKinds[0].dropOdds, powerupKinds[1].dropOdds, powerupKinds[2].dropOdds };
+    int effectTicks[POWERUP_KINDS] = { powerupKinds[0].ticks, powerupKinds[1].ticks, powerupKinds[2].ticks };
+
+    // accuracy
+    int totalShots = 0;
+    int hits = 0;
+
+    // game state
+    int round = 1;
+    int score = 0;
+    bool paused = false;
+    bool gameOver = false;
+    endReason ended = END_NONE;
+
+    // ticks left on each power-up effect
+    int effectTimer[POWERUP_KINDS] = {};
+    bool effectActive(int kind) const { return effectTimer[kind] > 0; }
+
+    // entities and their components, in dense stores the systems in sim.cpp loop over
+    entityPool<MAX_ENTITIES> entities;
+    componentStore<position, MAX_ENTITIES, MAX_ENTITIES> positions;
+    componentStore<velocity, MAX_ENTITIES, MAX_ENTITIES> velocities;
+    componentStore<pickup, MAX_POWERUPS, MAX_ENTITIES> pickups;
+
+    // what the last step() did, cleared at the start of every step
+    fixedVector<simEvent, MAX_EVENTS> events;
+
+    // how far the player and the formation moved on the last tick, for the
+    // swept collision tests
+    float playerMoved = 0;
+    float alienMovedX = 0, alienMovedY = 0;
+
+    // bullets, kept last: they are most of the struct but usually nearly
+    // empty, so snapshots copy everything before them plus the live bullets
+    bulletStream<MAX_PLAYER_BULLETS> playerBullets; // straight shots
+    bulletStream<MAX_HOMING_BULLETS> homingBullets; // shots fired while homing is active
+    bulletStream<MAX_ALIEN_BULLETS> alienBullets;
+};
+
+// simulation entry points (no GL in here, safe to run headless)
+void seedGame(game& g, uint64_t seed);
+void resetGame(game& g);
+void shoot(game& g);
+void checkCollisions(game& g);
+
+// advance by ticks ticks of play (1 = the normal fixed step). Longer steps
+// fast-forward: in acts on the first tick and its movement keys stay held.
+// The player, the formation, player and homing shots and pickups still go a
+// tick at a time; the alien shots, usually most of the work, move the whole
+// step in one go and each gets a swept test against the player's path over
+// the step, which says on which tick it gets there. So a long step plays the
+// same game as ticks steps of 1 with the same keys held: the same turns,
+// kills, drops, shots and rng draws, and the same end on the same tick. Only
+// the alien shots' positions can differ, in the last bits of the floats, so
+// a shot that just grazes the player box could in principle decide either way.
+// Returns the ticks played: a step stops on the tick the game ends (finding
+// the last round cleared takes a tick), plays none of a game already over
+// and all of them paused.
+int step(game& g, const input& in, int ticks = 1);
+
+// whether a tick with input next can ride along in a long step that started
+// with input first: the same movement keys and nothing that acts once
+inline bool heldInput(const input& first, const input& next) {
+    return next.left == first.left && next.right == first.right && !next.fire && !next.pause && !next.restart;
+}
+
+// round whose clearing ends the game
+int finalRound(const game& g);
+
+// how round's aliens aim in the built-in progression
+inline int builtinFirePattern(int round) { return round >= SPREAD_FIRE_ROUND ? FIRE_SPREAD : FIRE_STRAIGHT; }
+
+// direction (dx, dy) of an alien shot in the given firePattern, drawing from
+// random when the pattern has a choice to make
+void fireDirection(rng& random, int pattern, float& dx, float& dy);
+
+// lay out a (just reset) formation the way the built-in progression does: a
+// 60 x 40 pitch entering at (50, 400), with big formations entering higher
+// and packed tighter so they fit the screen above the invasion line
+void builtinLayout(formation& f, float& startX, float& startY);
+
+// falling pickup of the given kind at (x, y); NO_ENTITY when the stores are full
+entity spawnPowerup(game& g, int kind, float x, float y);
+void destroyEntity(game& g, entity e);
+
+// single phases of step(), exposed for the benchmarks; each does one tick,
+// alienFire() the given tick of a step of ticks ticks
+void steerHoming(game& g);
+void alienFire(game& g, int tick = 1, int ticks = 1);
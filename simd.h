@@ -0,0 +1,8 @@
+#pragma once
+
+// SSE2 is baseline on x64 and on every x86 target we ship; everything that uses
+// it keeps a scalar fallback for other architectures
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SI_SSE2 1
+#endif
@@ -0,0 +1,28 @@
+#include "snapshot.h"
+
+history::history(int capacity) : slots(capacity > 0 ? capacity : 1) {
+}
+
+void history::capture(const game& g) {
+    saveState(g, slots[head]);
+    head = (head + 1) % (int)slots.size();
+    if (count < (int)slots.size()) count++;
+}
+
+const game& history::at(int ago) const {
+    int n = (int)slots.size();
+    return slots[((head - 1 - ago) % n + n) % n];
+}
+
+int history::rewind(game& g, int ticks) {
+    if (count == 0) return 0;
+    if (ticks > count - 1) ticks = count - 1;
+
+    restoreState(g, at(ticks));
+
+    // the restored capture becomes the latest one
+    int n = (int)slots.size();
+    head = ((head - ticks) % n + n) % n;
+    count -= ticks;
+    return ticks;
+}
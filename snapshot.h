@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "sim.h"
+
+// the whole simulation lives inline in struct game (fixed-capacity pools, rng
+// state, bitboard), so a snapshot is just another game: saving or restoring a
+// moment of play is a few memcpys and never allocates. The bullet streams sit
+// at the end of game and only their live part is copied, which keeps the cost
+// near the size of the actual state rather than the pool capacity.
+static_assert(std::is_trivially_copyable<game>::value, "game must stay trivially copyable for snapshots");
+static_assert(std::is_standard_layout<game>::value, "snapshots copy game by offset");
+
+inline void saveState(const game& g, game& out) {
+    memcpy((void*)&out, (const void*)&g, offsetof(game, playerBullets));
+    out.playerBullets.copyFrom(g.playerBullets);
+    out.homingBullets.copyFrom(g.homingBullets);
+    out.alienBullets.copyFrom(g.alienBullets);
+}
+
+inline void restoreState(game& g, const game& saved) { saveState(saved, g); }
+
+// ring buffer of the most recent ticks. All slots are allocated up front;
+// capture() overwrites the oldest one once the ring is full.
+struct history {
+    explicit history(int capacity);
+
+    void capture(const game& g);
+    void clear() { head = count = 0; }
+
+    int size() const { return count; }
+    int capacity() const { return (int)slots.size(); }
+
+    // state from `ago` captures back (0 = latest), ago < size()
+    const game& at(int ago) const;
+
+    // restore the state from `ticks` captures back and forget everything newer;
+    // steps back as far as the ring reaches and returns how far that was
+    int rewind(game& g, int ticks);
+
+private:
+    std::vector<game> slots;
+    int head = 0;  // next slot to write
+    int count = 0; // slots holding a capture
+};
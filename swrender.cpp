@@ -0,0 +1,283 @@
+#include "swrender.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "sim.h"
+
+// 5x7 glyphs, one byte per row (bit 4 = leftmost column), top row first;
+// lowercase draws as uppercase and anything missing as a blank
+static const char FONT_CHARS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ:.%-()/_";
+static const uint8_t FONT_ROWS[][7] = {
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // 0
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 1
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // 2
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 3
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // 4
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 5
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // 6
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // 8
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 9
+    { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 }, // A
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // B
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // C
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // D
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // E
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // F
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // G
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // H
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // I
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // J
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // K
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // L
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // M
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // N
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // O
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // P
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // Q
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // R
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // S
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // T
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // U
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // V
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // W
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // X
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, // Y
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // Z
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // :
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // .
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // %
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // -
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // (
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // )
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // /
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, // _
+};
+
+// triangle vertices are snapped to 1/16 pixel
+static const int SUBPIXEL = 16;
+
+static uint8_t toByte(float v) {
+    return (uint8_t)(v <= 0.0f ? 0 : v >= 1.0f ? 255 : (int)(v * 255.0f + 0.5f));
+}
+
+softRenderer::softRenderer(int width_, int height_)
+    : width(width_), height(height_), pixels((size_t)width_ * height_ * 3),
+      scaleX((float)width_ / WIDTH), scaleY((float)height_ / HEIGHT) {}
+
+void softRenderer::clear() {
+    std::fill(pixels.begin(), pixels.end(), (uint8_t)0);
+}
+
+void softRenderer::triangles(const vertex* v, int count) {
+    for (int i = 0; i + 2 < count; i += 3)
+        triangle(v[i], v[i + 1], v[i + 2]);
+}
+
+void softRenderer::triangle(const vertex& va, const vertex& vb, const vertex& vc) {
+    // to fixed-point pixel coordinates, y down
+    const vertex* v[3] = { &va, &vb, &vc };
+    int64_t x[3], y[3];
+    for (int i = 0; i < 3; i++) {
+        x[i] = (int64_t)(v[i]->x * scaleX * SUBPIXEL + 0.5f);
+        y[i] = (int64_t)((HEIGHT - v[i]->y) * scaleY * SUBPIXEL + 0.5f);
+    }
+
+    int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(v[1], v[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        area = -area;
+    }
+
+    int minX = (int)(std::min({ x[0], x[1], x[2] }) / SUBPIXEL);
+    int maxX = (int)((std::max({ x[0], x[1], x[2] }) + SUBPIXEL - 1) / SUBPIXEL);
+    int minY = (int)(std::min({ y[0], y[1], y[2] }) / SUBPIXEL);
+    int maxY = (int)((std::max({ y[0], y[1], y[2] }) + SUBPIXEL - 1) / SUBPIXEL);
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, width - 1);
+    maxY = std::min(maxY, height - 1);
+    if (minX > maxX || minY > maxY) return;
+
+    // edge e runs from vertex e+1 to e+2, so its function is vertex e's weight.
+    // An edge shared by two triangles runs opposite ways in each, so exactly
+    // one of them owns the pixels lying on it
+    int64_t stepX[3], stepY[3], row[3];
+    int64_t px = (int64_t)minX * SUBPIXEL + SUBPIXEL / 2;
+    int64_t py = (int64_t)minY * SUBPIXEL + SUBPIXEL / 2;
+    for (int e = 0; e < 3; e++) {
+        int a = (e + 1) % 3, b = (e + 2) % 3;
+        int64_t dx = x[b] - x[a], dy = y[b] - y[a];
+        bool owner = dy > 0 || (dy == 0 && dx < 0);
+        stepX[e] = -dy * SUBPIXEL;
+        stepY[e] = dx * SUBPIXEL;
+        row[e] = dx * (py - y[a]) - dy * (px - x[a]) - (owner ? 0 : 1);
+    }
+
+    // meshes are colored per triangle, so most triangles take the flat path
+    bool flat = memcmp(&va.r, &vb.r, 4 * sizeof(float)) == 0 && memcmp(&va.r, &vc.r, 4 * sizeof(float)) == 0;
+    if (flat) {
+        int alpha = (int)(std::min(std::max(va.a, 0.0f), 1.0f) * 256.0f + 0.5f);
+        if (alpha == 0) return;
+        int sr = toByte(va.r) * alpha, sg = toByte(va.g) * alpha, sb = toByte(va.b) * alpha;
+        int keep = 256 - alpha;
+        for (int py = minY; py <= maxY; py++) {
+            int64_t w0 = row[0], w1 = row[1], w2 = row[2];
+            uint8_t* p = &pixels[((size_t)py * width + minX) * 3];
+            for (int px = minX; px <= maxX; px++, p += 3) {
+                if ((w0 | w1 | w2) >= 0) {
+                    p[0] = (uint8_t)((sr + p[0] * keep) >> 8);
+                    p[1] = (uint8_t)((sg + p[1] * keep) >> 8);
+                    p[2] = (uint8_t)((sb + p[2] * keep) >> 8);
+                }
+                w0 += stepX[0]; w1 += stepX[1]; w2 += stepX[2];
+            }
+            for (int e = 0; e < 3; e++) row[e] += stepY[e];
+        }
+        return;
+    }
+
+    float inv = 1.0f / (float)area;
+    for (int py = minY; py <= maxY; py++) {
+        int64_t w0 = row[0], w1 = row[1], w2 = row[2];
+        uint8_t* p = &pixels[((size_t)py * width + minX) * 3];
+        for (int px = minX; px <= maxX; px++, p += 3) {
+            if ((w0 | w1 | w2) >= 0) {
+                float l0 = w0 * inv, l1 = w1 * inv, l2 = w2 * inv;
+                float a = l0 * v[0]->a + l1 * v[1]->a + l2 * v[2]->a;
+                float r = l0 * v[0]->r + l1 * v[1]->r + l2 * v[2]->r;
+                float g = l0 * v[0]->g + l1 * v[1]->g + l2 * v[2]->g;
+                float b = l0 * v[0]->b + l1 * v[1]->b + l2 * v[2]->b;
+                int alpha = (int)(std::min(std::max(a, 0.0f), 1.0f) * 256.0f + 0.5f), keep = 256 - alpha;
+                p[0] = (uint8_t)((toByte(r) * alpha + p[0] * keep) >> 8);
+                p[1] = (uint8_t)((toByte(g) * alpha + p[1] * keep) >> 8);
+                p[2] = (uint8_t)((toByte(b) * alpha + p[2] * keep) >> 8);
+            }
+            w0 += stepX[0]; w1 += stepX[1]; w2 += stepX[2];
+        }
+        for (int e = 0; e < 3; e++) row[e] += stepY[e];
+    }
+}
+
+void softRenderer::fill(int x0, int y0, int x1, int y1, uint8_t r, uint8_t g, uint8_t b) {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width);
+    y1 = std::min(y1, height);
+    for (int y = y0; y < y1; y++) {
+        uint8_t* p = &pixels[((size_t)y * width + x0) * 3];
+        for (int x = x0; x < x1; x++, p += 3) {
+            p[0] = r;
+            p[1] = g;
+            p[2] = b;
+        }
+    }
+}
+
+void softRenderer::text(int, const char* s, float x, float y, int size, float r, float g, float b) {
+    // 18px text gets 2x2 pixel dots, 12px text 1x1 (at 1:1 scale)
+    int dot = std::max(1, (int)(size * scaleY / 8));
+    int left = (int)(x * scaleX + 0.5f);
+    int top = (int)((HEIGHT - y) * scaleY + 0.5f) - 7 * dot;
+    uint8_t cr = toByte(r), cg = toByte(g), cb = toByte(b);
+
+    for (; *s; s++, left += 6 * dot) {
+        char c = *s >= 'a' && *s <= 'z' ? (char)(*s - 'a' + 'A') : *s;
+        const char* at = c ? strchr(FONT_CHARS, c) : nullptr;
+        if (!at) continue;
+        const uint8_t* rows = FONT_ROWS[at - FONT_CHARS];
+        for (int ry = 0; ry < 7; ry++)
+            for (int rx = 0; rx < 5; rx++)
+                if (rows[ry] & (0x10 >> rx))
+                    fill(left + rx * dot, top + ry * dot, left + (rx + 1) * dot, top + (ry + 1) * dot, cr, cg, cb);
+    }
+}
+
+bool softRenderer::savePPM(const char* path) const {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    bool ok = fwrite(pixels.data(), 1, pixels.size(), f) == pixels.size();
+    return fclose(f) == 0 && ok;
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t* p, size_t n) {
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    crc = ~crc;
+    while (n--) crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+
+// length, type, data, crc
+static void chunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    put32(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put32(out, crc32(0, &out[start], out.size() - start));
+}
+
+bool softRenderer::savePNG(const char* path) const {
+    // every row starts with filter type 0 (none)
+    size_t stride = (size_t)width * 3;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * height);
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels.begin() + y * stride, pixels.begin() + (y + 1) * stride);
+    }
+
+    // zlib stream made of stored (uncompressed) deflate blocks
+    std::vector<uint8_t> z = { 0x78, 0x01 };
+    uint32_t s1 = 1, s2 = 0;
+    for (size_t at = 0; at < raw.size() || at == 0; ) {
+        size_t n = std::min(raw.size() - at, (size_t)65535);
+        bool last = at + n == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back((uint8_t)n);
+        z.push_back((uint8_t)(n >> 8));
+        z.push_back((uint8_t)~n);
+        z.push_back((uint8_t)(~n >> 8));
+        z.insert(z.end(), raw.begin() + at, raw.begin() + at + n);
+        for (size_t i = at; i < at + n; i++) {
+            s1 = (s1 + raw[i]) % 65521;
+            s2 = (s2 + s1) % 65521;
+        }
+        at += n;
+        if (last) break;
+    }
+    put32(z, (s2 << 16) | s1);
+
+    std::vector<uint8_t> header;
+    put32(header, (uint32_t)width);
+    put32(header, (uint32_t)height);
+    header.insert(header.end(), { 8, 2, 0, 0, 0 }); // 8-bit RGB, no interlace
+
+    static const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> out(SIGNATURE, SIGNATURE + 8);
+    chunk(out, "IHDR", header);
+    chunk(out, "IDAT", z);
+    chunk(out, "IEND", {});
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "render.h"
+
+// renderer that rasterizes into an RGB framebuffer on the CPU, for frame
+// capture and render benchmarks on machines without a GPU. Triangles are
+// sampled at pixel centers with a top-left fill rule (shared edges of a fan
+// are blended once, like GL), colors are interpolated across the triangle,
+// and text uses a built-in 5x7 font in place of GLUT's bitmap fonts.
+struct softRenderer : renderer {
+    int width = 0, height = 0;
+    std::vector<uint8_t> pixels; // RGB, top row first
+
+    // the playfield is scaled to width x height
+    explicit softRenderer(int width, int height);
+
+    void clear() override;
+    void triangles(const vertex* v, int count) override;
+    void text(int slot, const char* s, float x, float y, int size,
+        float r = 1.0f, float g = 1.0f, float b = 1.0f) override;
+
+    // binary PPM (P6), or PNG with uncompressed deflate blocks
+    bool savePPM(const char* path) const;
+    bool savePNG(const char* path) const;
+
+private:
+    float scaleX = 1, scaleY = 1; // playfield units to pixels
+
+    void triangle(const vertex& a, const vertex& b, const vertex& c);
+    void fill(int x0, int y0, int x1, int y1, uint8_t r, uint8_t g, uint8_t b);
+};
@@ -0,0 +1,160 @@
+#include "targeting.h"
+#include <algorithm>
+#include <cstring>
+#include "simd.h"
+
+// same cut-off the original scan started from
+static const float NO_TARGET = 1e9f;
+
+targetIndex::targetIndex() {
+    // worst case every column is padded by 3
+    size_t most = MAX_FORMATION_ROWS * MAX_FORMATION_COLS + 3 * MAX_FORMATION_COLS;
+    colX.reserve(MAX_FORMATION_COLS);
+    start.reserve(MAX_FORMATION_COLS + 1);
+    offX.reserve(most);
+    offY.reserve(most);
+    rank.reserve(most);
+}
+
+void targetIndex::update(const formation& f) {
+    if (f.rows == rows && f.cols == cols && f.pitchX == pitchX && f.pitchY == pitchY &&
+        memcmp(f.row, rowBits, sizeof(uint64_t) * rows) == 0)
+        return;
+
+    rows = f.rows;
+    cols = f.cols;
+    pitchX = f.pitchX;
+    pitchY = f.pitchY;
+    memcpy(rowBits, f.row, sizeof(rowBits));
+
+    colX.clear();
+    start.clear();
+    offX.clear();
+    offY.clear();
+    rank.clear();
+    for (uint64_t mask = f.colMask; mask; mask &= mask - 1) {
+        int x = lowestBit(mask);
+        colX.push_back(x * pitchX);
+        start.push_back((int)offY.size());
+        for (uint64_t bits = f.col[x]; bits; bits &= bits - 1) {
+            int y = lowestBit(bits);
+            offX.push_back(x * pitchX);
+            offY.push_back(y * pitchY);
+            rank.push_back(y * MAX_FORMATION_COLS + x);
+        }
+        // pad so the SIMD loop never needs a tail
+        while (offY.size() % 4) {
+            offX.push_back(0.0f);
+            offY.push_back(-NO_TARGET);
+            rank.push_back(INT32_MAX);
+        }
+    }
+    start.push_back((int)offY.size());
+}
+
+int targetIndex::nearestOne(float alienX, float alienY, float px, float py) const {
+    int n = (int)colX.size();
+    if (n == 0) return -1;
+
+    // first column at or right of the point, so distances only grow walking away from it
+    int pos = (int)(std::lower_bound(colX.begin(), colX.end(), px,
+        [alienX](float cx, float p) { return alienX + cx < p; }) - colX.begin());
+
+#ifdef SI_SSE2
+    __m128 bestD = _mm_set1_ps(NO_TARGET);
+    __m128i bestRank = _mm_set1_epi32(INT32_MAX);
+    __m128i bestIdx = _mm_set1_epi32(-1);
+    const __m128 vAlienY = _mm_set1_ps(alienY);
+    const __m128 vPy = _mm_set1_ps(py);
+    const __m128i four = _mm_set1_epi32(4);
+#else
+    float bestD = NO_TARGET;
+    int bestRank = INT32_MAX, bestIdx = -1;
+#endif
+
+    // walk outwards; a column whose horizontal distance alone is worse than
+    // the best hit (and every column beyond it) can be skipped
+    int left = pos - 1, right = pos;
+    while (left >= 0 || right < n) {
+        int j;
+        float dxl = left >= 0 ? (alienX + colX[left]) - px : 0.0f;
+        float dxr = right < n ? (alienX + colX[right]) - px : 0.0f;
+        if (right >= n || (left >= 0 && dxl * dxl <= dxr * dxr)) j = left--;
+        else j = right++;
+
+        float dx = (alienX + colX[j]) - px;
+        float dx2 = dx * dx;
+
+#ifdef SI_SSE2
+        float worst[4];
+        _mm_storeu_ps(worst, bestD);
+        float best = worst[0];
+        for (int l = 1; l < 4; l++) if (worst[l] < best) best = worst[l];
+        if (dx2 > best) {
+            // columns further out on this side can't win either
+            if (j < pos) left = -1; else right = n;
+            continue;
+        }
+
+        const __m128 vDx2 = _mm_set1_ps(dx2);
+        __m128i idx = _mm_add_epi32(_mm_set1_epi32(start[j]), _mm_set_epi32(3, 2, 1, 0));
+        for (int k = start[j]; k < start[j + 1]; k += 4) {
+            __m128 ay = _mm_sub_ps(vAlienY, _mm_loadu_ps(&offY[k]));
+            __m128 dy = _mm_sub_ps(ay, vPy);
+            __m128 d = _mm_add_ps(vDx2, _mm_mul_ps(dy, dy));
+            __m128i r = _mm_loadu_si128((const __m128i*)&rank[k]);
+
+            __m128 lt = _mm_cmplt_ps(d, bestD);
+            __m128 eq = _mm_cmpeq_ps(d, bestD);
+            __m128i rlt = _mm_cmplt_epi32(r, bestRank);
+            __m128i take = _mm_or_si128(_mm_castps_si128(lt), _mm_and_si128(_mm_castps_si128(eq), rlt));
+
+            bestD = _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(take), d), _mm_andnot_ps(_mm_castsi128_ps(take), bestD));
+            bestRank = _mm_or_si128(_mm_and_si128(take, r), _mm_andnot_si128(take, bestRank));
+            bestIdx = _mm_or_si128(_mm_and_si128(take, idx), _mm_andnot_si128(take, bestIdx));
+            idx = _mm_add_epi32(idx, four);
+        }
+#else
+        if (dx2 > bestD) {
+            if (j < pos) left = -1; else right = n;
+            continue;
+        }
+        for (int k = start[j]; k < start[j + 1]; k++) {
+            float dy = (alienY - offY[k]) - py;
+            float d = dx2 + dy * dy;
+            if (d < bestD || (d == bestD && rank[k] < bestRank)) {
+                bestD = d;
+                bestRank = rank[k];
+                bestIdx = k;
+            }
+        }
+#endif
+    }
+
+#ifdef SI_SSE2
+    // reduce the four lanes the same way
+    float d[4];
+    int r[4], idx[4];
+    _mm_storeu_ps(d, bestD);
+    _mm_storeu_si128((__m128i*)r, bestRank);
+    _mm_storeu_si128((__m128i*)idx, bestIdx);
+    int best = 0;
+    for (int l = 1; l < 4; l++)
+        if (d[l] < d[best] || (d[l] == d[best] && r[l] < r[best])) best = l;
+    return idx[best];
+#else
+    return bestIdx;
+#endif
+}
+
+void targetIndex::nearest(float alienX, float alienY, const float* px, const float* py, int n,
+    float* tx, float* ty, unsigned char* found) const {
+    for (int i = 0; i < n; i++) {
+        int k = nearestOne(alienX, alienY, px[i], py[i]);
+        found[i] = k >= 0;
+        if (k >= 0) {
+            tx[i] = alienX + offX[k];
+            ty[i] = alienY - offY[k];
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "formation.h"
+
+// nearest-alive-alien lookup for homing bullets. The index stores each alive
+// alien's offset from the formation anchor (alienX, alienY), grouped by column,
+// so it stays valid while the formation moves and is only rebuilt when aliens
+// die or respawn. Queries walk out from the bullet's column, stop as soon as
+// the column distance alone is worse than the best hit, and test the rows of
+// a column four at a time with SSE.
+struct targetIndex {
+
+    // reserves room for the biggest formation up front
+    targetIndex();
+
+    // rebuild if the formation changed since the last call
+    void update(const formation& f);
+
+    // nearest alive alien to each of the n points (px[i], py[i]); ties go to
+    // the first alien in row-major order, same as a plain scan would pick
+    void nearest(float alienX, float alienY, const float* px, const float* py, int n,
+        float* tx, float* ty, unsigned char* found) const;
+
+private:
+    // formation this index was built from
+    int rows = -1, cols = 0;
+    float pitchX = 0, pitchY = 0;
+    uint64_t rowBits[MAX_FORMATION_ROWS] = {};
+
+    // non-empty columns, left to right; column j owns aliens [start[j], start[j + 1])
+    // which are padded to a multiple of 4 with entries that can never win
+    std::vector<float> colX;
+    std::vector<int> start;
+
+    std::vector<float> offX, offY; // per alien: x offset right of / y offset below the anchor
+    std::vector<int> rank;         // per alien: row-major position, for ties
+
+    int nearestOne(float alienX, float alienY, float px, float py) const;
+};
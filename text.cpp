@@ -0,0 +1,44 @@
+#include "text.h"
+#include <GL/glut.h>
+#include <cstring>
+
+// glyphs 32..126, the rest are left empty
+static const int FIRST_GLYPH = 32, LAST_GLYPH = 126;
+static const int GLYPHS = 128;
+
+void glyphFont::build(void* glutFont) {
+    font = glutFont;
+    base = glGenLists(GLYPHS);
+    for (int c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+        glNewList(base + c, GL_COMPILE);
+        glutBitmapCharacter(font, c);
+        glEndList();
+    }
+}
+
+void glyphFont::draw(const char* s, float x, float y) const {
+    glRasterPos2f(x, y);
+    glListBase(base);
+    glCallLists((GLsizei)strlen(s), GL_UNSIGNED_BYTE, s);
+}
+
+void textLine::set(const glyphFont& f, const char* s, float x_, float y_, float r_, float g_, float b_) {
+    if (list && font == &f && x == x_ && y == y_ && r == r_ && g == g_ && b == b_ && !strcmp(text, s))
+        return;
+
+    strncpy(text, s, sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    font = &f;
+    x = x_; y = y_;
+    r = r_; g = g_; b = b_;
+
+    if (!list) list = glGenLists(1);
+    glNewList(list, GL_COMPILE);
+    glColor3f(r, g, b); // the raster position picks up the current color
+    f.draw(text, x, y);
+    glEndList();
+}
+
+void textLine::draw() const {
+    if (list) glCallList(list);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// GLUT bitmap font with every printable glyph compiled into a display list
+// once, so a string is one glCallLists instead of a glutBitmapCharacter call
+// per character
+struct glyphFont {
+    void* font = nullptr; // GLUT_BITMAP_*
+    unsigned int base = 0;
+
+    void build(void* glutFont);
+
+    // draw at (x, y) in the current color
+    void draw(const char* s, float x, float y) const;
+};
+
+// one line of text (color, position and glyphs) cached as a display list;
+// set() only recompiles it when something changed
+struct textLine {
+    void set(const glyphFont& f, const char* s, float x, float y, float r = 1.0f, float g = 1.0f, float b = 1.0f);
+    void draw() const;
+
+private:
+    unsigned int list = 0;
+    char text[96] = "";
+    const glyphFont* font = nullptr;
+    float x = 0, y = 0, r = 0, g = 0, b = 0;
+};
@@ -0,0 +1,168 @@
+// wave compiler: turns a text wave list into the binary table the game maps
+//
+//   # comment
+//   rows 4              keys before the first wave set what wave 1 starts from
+//   wave [N]            N waves (default 1), each starting from the wave before
+//   rows R / cols C     formation size
+//   pitch X Y           spacing between aliens
+//   start X Y           where the formation enters
+//   speed V | speed *F  formation px per tick, or the previous speed times F
+//   fire ODDS VOLLEY    each tick 1 in ODDS chance that VOLLEY aliens shoot
+//   bullets SPEED straight|spread
+//   drop KIND ODDS      1 in ODDS power-up drop per kill (0 = never), KIND slow/homing/shield
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "waves.h"
+
+static const char* PATTERN_NAMES[FIRE_PATTERNS] = { "straight", "spread" };
+
+// one "key args..." line of a wave block, kept to replay on every copy of the wave
+struct waveLine {
+    int number;
+    std::vector<std::string> words;
+};
+
+static bool toInt(const std::string& s, int32_t& out) {
+    char* end;
+    long v = strtol(s.c_str(), &end, 10);
+    if (s.empty() || *end) return false;
+    out = (int32_t)v;
+    return true;
+}
+
+static bool toFloat(const std::string& s, float& out) {
+    char* end;
+    out = strtof(s.c_str(), &end);
+    return !s.empty() && !*end;
+}
+
+// apply one line to w; an error message, or nullptr
+static const char* apply(waveDef& w, const std::vector<std::string>& words) {
+    const std::string& key = words[0];
+    size_t args = words.size() - 1;
+    if (key == "rows" && args == 1) return toInt(words[1], w.rows) ? nullptr : "rows wants a number";
+    if (key == "cols" && args == 1) return toInt(words[1], w.cols) ? nullptr : "cols wants a number";
+    if (key == "pitch" && args == 2)
+        return toFloat(words[1], w.pitchX) && toFloat(words[2], w.pitchY) ? nullptr : "pitch wants two numbers";
+    if (key == "start" && args == 2)
+        return toFloat(words[1], w.startX) && toFloat(words[2], w.startY) ? nullptr : "start wants two numbers";
+    if (key == "speed" && args == 1) {
+        float f;
+        if (words[1][0] == '*') {
+            if (!toFloat(words[1].substr(1), f)) return "speed wants a number or *factor";
+            w.speed *= f; // same float math the built-in progression does per round
+            return nullptr;
+        }
+        return toFloat(words[1], w.speed) ? nullptr : "speed wants a number or *factor";
+    }
+    if (key == "fire" && args == 2)
+        return toInt(words[1], w.fireOdds) && toInt(words[2], w.volley) ? nullptr : "fire wants odds and volley";
+    if (key == "bullets" && args == 2) {
+        if (!toFloat(words[1], w.bulletSpeed)) return "bullets wants a speed";
+        for (int p = 0; p < FIRE_PATTERNS; p++) {
+            if (words[2] == PATTERN_NAMES[p]) {
+                w.pattern = p;
+                return nullptr;
+            }
+        }
+        return "unknown fire pattern";
+    }
+    if (key == "drop" && args == 2) {
+        for (int k = 0; k < POWERUP_KINDS; k++)
+            if (words[1] == powerupKinds[k].name)
+                return toInt(words[2], w.dropOdds[k]) ? nullptr : "drop wants odds";
+        return "unknown power-up kind";
+    }
+    return "unknown key or wrong number of values";
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printf("usage: %s WAVES.txt WAVES.bin\n", argv[0]);
+        return 1;
+    }
+    const char* inPath = argv[1];
+    FILE* in = fopen(inPath, "r");
+    if (!in) {
+        printf("could not read %s\n", inPath);
+        return 1;
+    }
+
+    std::vector<waveDef> waves;
+    waveDef prev = defaultWave();
+    std::vector<waveLine> block;
+    int copies = 0; // of the open wave block, 0 = still in the defaults before the first wave
+    int blockLine = 0;
+    std::string error;
+
+    // emit the open block: each copy replays its lines on top of the wave before
+    auto flush = [&]() {
+        for (int c = 0; c < copies && error.empty(); c++) {
+            waveDef w = prev;
+            for (const waveLine& l : block) {
+                if (const char* e = apply(w, l.words)) {
+                    error = std::to_string(l.number) + ": " + e;
+                    return;
+                }
+            }
+            if (const char* e = checkWave(w)) {
+                error = std::to_string(blockLine) + ": " + e;
+                return;
+            }
+            waves.push_back(w);
+            prev = w;
+        }
+        block.clear();
+    };
+
+    char buf[1024];
+    int number = 0;
+    while (error.empty() && fgets(buf, sizeof(buf), in)) {
+        number++;
+        if (char* hash = strchr(buf, '#')) *hash = 0;
+        std::vector<std::string> words;
+        for (char* w = strtok(buf, " \t\r\n"); w; w = strtok(nullptr, " \t\r\n")) words.push_back(w);
+        if (words.empty()) continue;
+
+        if (words[0] == "wave") {
+            flush();
+            int32_t n = 1;
+            if (words.size() > 2 || (words.size() == 2 && (!toInt(words[1], n) || n < 1)))
+                error = std::to_string(number) + ": wave wants an optional count of at least 1";
+            else if ((long long)waves.size() + n > MAX_WAVES) // before copying any of them
+                error = std::to_string(number) + ": more than " + std::to_string(MAX_WAVES) + " waves";
+            copies = n;
+            blockLine = number;
+        }
+        else if (copies == 0) {
+            if (const char* e = apply(prev, words)) error = std::to_string(number) + ": " + e;
+        }
+        else block.push_back({ number, words });
+    }
+    fclose(in);
+    if (error.empty()) flush();
+    if (error.empty() && waves.empty()) error = " no waves";
+    if (!error.empty()) {
+        printf("%s:%s\n", inPath, error.c_str());
+        return 1;
+    }
+
+    waveHeader h;
+    memcpy(h.magic, WAVE_MAGIC, 4);
+    h.version = WAVE_VERSION;
+    h.count = (uint32_t)waves.size();
+    h.waveSize = sizeof(waveDef);
+    FILE* out = fopen(argv[2], "wb");
+    bool ok = out && fwrite(&h, sizeof(h), 1, out) == 1 &&
+        fwrite(waves.data(), sizeof(waveDef), waves.size(), out) == waves.size();
+    if (out && fclose(out) != 0) ok = false;
+    if (!ok) {
+        printf("could not write %s\n", argv[2]);
+        return 1;
+    }
+    printf("%zu waves written to %s\n", waves.size(), argv[2]);
+    return 0;
+}
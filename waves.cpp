@@ -0,0 +1,128 @@
+#include "waves.h"
+#include <cstring>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+waveDef defaultWave() {
+    waveDef w;
+    w.rows = ALIEN_ROWS;
+    w.cols = ALIEN_COLS;
+    w.pitchX = 60;
+    w.pitchY = 40;
+    w.startX = 50;
+    w.startY = 400;
+    w.speed = 0.5f;
+    w.fireOdds = 25;
+    w.volley = 1;
+    w.bulletSpeed = ALIEN_BULLET_SPEED;
+    w.pattern = FIRE_STRAIGHT;
+    for (int k = 0; k < POWERUP_KINDS; k++) w.dropOdds[k] = powerupKinds[k].dropOdds;
+    return w;
+}
+
+const char* checkWave(const waveDef& w) {
+    if (w.rows < 1 || w.rows > MAX_FORMATION_ROWS) return "rows out of range";
+    if (w.cols < 1 || w.cols > MAX_FORMATION_COLS) return "cols out of range";
+    if (!(w.pitchX > 0) || !(w.pitchY > 0)) return "pitch must be positive";
+    if (!(w.speed >= 0) || !(w.bulletSpeed > 0)) return "speeds must be positive";
+    if (w.fireOdds < 1) return "fire odds must be at least 1";
+    if (w.volley < 0) return "negative volley";
+    if (w.pattern < 0 || w.pattern >= FIRE_PATTERNS) return "unknown fire pattern";
+    for (int k = 0; k < POWERUP_KINDS; k++)
+        if (w.dropOdds[k] < 0) return "negative drop odds";
+    return nullptr;
+}
+
+bool waveFile::open(const char* path) {
+    close();
+    error = "";
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "could not open the file";
+        return false;
+    }
+    LARGE_INTEGER bytes;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &bytes) && bytes.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // the view keeps the mapping alive
+    }
+    CloseHandle(file);
+    size = view ? (size_t)bytes.QuadPart : 0;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        error = "could not open the file";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            view = p;
+            size = (size_t)st.st_size;
+        }
+    }
+    ::close(fd); // the mapping outlives the descriptor
+#endif
+    if (!view) {
+        error = "could not map the file";
+        return false;
+    }
+
+    // everything is checked once here, so the sim can use the table as is
+    const waveHeader* h = (const waveHeader*)view;
+    if (size < sizeof(waveHeader) || memcmp(h->magic, WAVE_MAGIC, 4) != 0) error = "not a wave file";
+    else if (h->version != WAVE_VERSION || h->waveSize != sizeof(waveDef)) error = "unsupported wave file version";
+    else if (h->count < 1 || h->count > (uint32_t)MAX_WAVES || size != sizeof(waveHeader) + h->count * sizeof(waveDef))
+        error = "wave count does not match the file size";
+    else {
+        waves = (const waveDef*)(h + 1);
+        count = (int)h->count;
+        for (int i = 0; i < count; i++) {
+            if (checkWave(waves[i])) {
+                error = checkWave(waves[i]);
+                break;
+            }
+        }
+        if (!*error) return true;
+    }
+    close();
+    return false;
+}
+
+void waveFile::close() {
+    if (view) {
+#if defined(_WIN32)
+        UnmapViewOfFile(view);
+#else
+        munmap((void*)view, size);
+#endif
+    }
+    view = nullptr;
+    size = 0;
+    waves = nullptr;
+    count = 0;
+}
+
+uint64_t wavesHash(const game& g) {
+    if (!g.waves) return 0;
+    uint64_t h = 14695981039346656037ull;
+    const unsigned char* p = (const unsigned char*)g.waves;
+    for (size_t i = 0; i < (size_t)g.waveCount * sizeof(waveDef); i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
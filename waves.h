@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include "sim.h"
+
+// wave data: each round's formation, movement, fire and drop tables. Waves are
+// written as text (see waves.txt), compiled to a flat binary by
+// space-invaders-wavec and memory-mapped by the game, so loading a level set
+// is one map call and starting a round is a copy out of the table.
+//
+// file layout (little-endian): waveHeader, then header.count waveDefs
+
+const char WAVE_MAGIC[4] = { 'S', 'I', 'W', 'V' };
+const uint32_t WAVE_VERSION = 1;
+const int MAX_WAVES = 100000;
+
+struct waveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;    // waves in the file
+    uint32_t waveSize; // sizeof(waveDef) the file was written with
+};
+
+struct waveDef {
+    int32_t rows, cols;       // formation size
+    float pitchX, pitchY;     // spacing between aliens
+    float startX, startY;     // where the formation enters
+    float speed;              // formation px per tick
+    int32_t fireOdds, volley; // each tick 1 in fireOdds chance that volley aliens shoot
+    float bulletSpeed;        // alien bullet px per tick
+    int32_t pattern;          // firePattern
+    int32_t dropOdds[POWERUP_KINDS];
+};
+
+static_assert(sizeof(waveHeader) == 16 && sizeof(waveDef) == 56, "wave files are read in place");
+
+// the default wave settings a text file starts from (the built-in first round)
+waveDef defaultWave();
+
+// why a wave is unusable, or nullptr when it is fine
+const char* checkWave(const waveDef& w);
+
+// a wave file mapped read-only; waves stay valid until close() or destruction
+struct waveFile {
+    const waveDef* waves = nullptr;
+    int count = 0;
+
+    waveFile() = default;
+    waveFile(const waveFile&) = delete;
+    waveFile& operator=(const waveFile&) = delete;
+    ~waveFile() { close(); }
+
+    // false (with error set) when the file is missing, malformed or has a bad wave
+    bool open(const char* path);
+    void close();
+
+    // play g's rounds from these waves; call before resetGame()
+    void use(game& g) const {
+        g.waves = waves;
+        g.waveCount = count;
+    }
+
+    const char* error = "";
+
+private:
+    const void* view = nullptr;
+    size_t size = 0;
+};
+
+// FNV-1a of the wave table g plays, 0 for the built-in progression; replays
+// store it so they are only played back against the same waves
+uint64_t wavesHash(const game& g);
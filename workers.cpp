@@ -0,0 +1,93 @@
+#include "workers.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// one worker's share of the range, on its own cache line so workers taking
+// from their own slice don't contend. begin/end only change under the lock;
+// they are atomic so thieves can peek at the size without taking it.
+struct alignas(64) slice {
+    std::mutex lock;
+    std::atomic<int> begin{ 0 }, end{ 0 };
+
+    int left() const { return end.load(std::memory_order_relaxed) - begin.load(std::memory_order_relaxed); }
+};
+
+bool popFront(slice& s, int& i) {
+    std::lock_guard<std::mutex> hold(s.lock);
+    int b = s.begin.load(std::memory_order_relaxed);
+    if (b >= s.end.load(std::memory_order_relaxed)) return false;
+    s.begin.store(b + 1, std::memory_order_relaxed);
+    i = b;
+    return true;
+}
+
+// move the back half of the fullest other slice into mine; false once
+// every slice is empty
+bool steal(slice* slices, int n, int self) {
+    for (;;) {
+        int victim = -1, most = 0;
+        for (int v = 0; v < n; v++) {
+            int left = slices[v].left();
+            if (v != self && left > most) {
+                most = left;
+                victim = v;
+            }
+        }
+        if (victim < 0) return false;
+
+        int from, to;
+        {
+            slice& s = slices[victim];
+            std::lock_guard<std::mutex> hold(s.lock);
+            int left = s.left();
+            if (left <= 0) continue; // someone got there first, look again
+            to = s.end.load(std::memory_order_relaxed);
+            from = to - (left + 1) / 2;
+            s.end.store(from, std::memory_order_relaxed);
+        }
+
+        slice& mine = slices[self];
+        std::lock_guard<std::mutex> hold(mine.lock);
+        mine.begin.store(from, std::memory_order_relaxed);
+        mine.end.store(to, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+}
+
+int hardwareThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 1;
+}
+
+void parallelFor(int count, int threads, const std::function<void(int, int)>& fn) {
+    if (count <= 0) return;
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count;
+
+    std::unique_ptr<slice[]> slices(new slice[threads]);
+    for (int t = 0; t < threads; t++) {
+        slices[t].begin = (int)((long long)count * t / threads);
+        slices[t].end = (int)((long long)count * (t + 1) / threads);
+    }
+
+    auto work = [&](int self) {
+        int i;
+        for (;;) {
+            while (popFront(slices[self], i)) fn(i, self);
+            if (!steal(slices.get(), threads, self)) return;
+        }
+    };
+
+    // the calling thread is worker 0
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(work, t);
+    work(0);
+    for (auto& t : pool) t.join();
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <functional>
+
+// run fn(i, worker) for every i in [0, count) on `threads` threads (worker is
+// the calling thread's index, for per-thread scratch). Each thread starts with
+// an even slice of the range and takes indices from its front; one that runs
+// dry steals the back half of the fullest remaining slice, so jobs of very
+// different lengths still keep every core busy.
+void parallelFor(int count, int threads, const std::function<void(int, int)>& fn);
+
+// threads the machine can run at once (at least 1)
+int hardwareThreads();